@@ -0,0 +1,150 @@
+// times every multiplication algorithm of big_multiply.hpp over a range of
+// operand sizes and prints from where on each one keeps beating the
+// previous one, karatsubaThreshold and nttThreshold come from its output
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "core/big_multiply.hpp"
+
+namespace {
+using mandel::core::multiplyAlgorithm;
+
+constexpr const char* algorithmNames[] = {"schoolbook", "karatsuba", "ntt"};
+
+// median time of one product in microseconds
+double timeMultiply(
+    const multiplyAlgorithm algorithm,
+    const std::vector<std::uint32_t>& a,
+    const std::vector<std::uint32_t>& b,
+    std::vector<std::uint32_t>& product) {
+    using clock = std::chrono::steady_clock;
+
+    // enough repetitions for about a millisecond per sample
+    std::size_t repetitions = 1;
+
+    for (;;) {
+        const auto start = clock::now();
+
+        for (std::size_t r = 0; r < repetitions; ++r) {
+            mandel::core::MultiplyLimbs(
+                algorithm,
+                a.data(),
+                a.size(),
+                b.data(),
+                b.size(),
+                product.data());
+        }
+
+        if (clock::now() - start > std::chrono::milliseconds(1))
+            break;
+
+        repetitions *= 2;
+    }
+
+    std::vector<double> samples(5);
+
+    for (double& sample : samples) {
+        const auto start = clock::now();
+
+        for (std::size_t r = 0; r < repetitions; ++r) {
+            mandel::core::MultiplyLimbs(
+                algorithm,
+                a.data(),
+                a.size(),
+                b.data(),
+                b.size(),
+                product.data());
+        }
+
+        sample = std::chrono::duration<double, std::micro>(
+                     clock::now() - start)
+                     .count()
+            / static_cast<double>(repetitions);
+    }
+
+    std::nth_element(samples.begin(), samples.begin() + 2, samples.end());
+
+    return samples[2];
+}
+}  // namespace
+
+int main() {
+    constexpr std::size_t algorithmCount =
+        static_cast<std::size_t>(multiplyAlgorithm::count);
+
+    std::mt19937 random(1);
+
+    // size from which on algorithm i beat algorithm i - 1 at every size
+    // measured, 0 if it lost at the largest one
+    std::size_t crossovers[algorithmCount] = {};
+
+    std::printf("%8s %8s", "limbs", "bits");
+    for (const char* name : algorithmNames)
+        std::printf(" %12s", name);
+    std::printf("   (microseconds per product)\n");
+
+    for (std::size_t size = 8; size <= 32768; size += size / 4) {
+        std::vector<std::uint32_t> a(size), b(size), product(2 * size);
+        std::vector<std::uint32_t> expected(2 * size);
+
+        for (std::size_t i = 0; i < size; ++i) {
+            a[i] = static_cast<std::uint32_t>(random());
+            b[i] = static_cast<std::uint32_t>(random());
+        }
+
+        std::printf("%8zu %8zu", size, size * 32);
+
+        double times[algorithmCount];
+        bool bExpected = false;
+
+        for (std::size_t i = 0; i < algorithmCount; ++i) {
+            const multiplyAlgorithm algorithm =
+                static_cast<multiplyAlgorithm>(i);
+
+            // schoolbook gets slow enough to skip well past the karatsuba
+            // crossover
+            if (algorithm == multiplyAlgorithm::schoolbook && size > 4096) {
+                times[i] = -1.0;
+                std::printf(" %12s", "-");
+                continue;
+            }
+
+            times[i] = timeMultiply(algorithm, a, b, product);
+            std::printf(" %12.2f", times[i]);
+
+            // every product is checked against the first one measured
+            if (!bExpected) {
+                expected = product;
+                bExpected = true;
+            } else if (product != expected) {
+                std::printf("\n%s product is wrong\n", algorithmNames[i]);
+                return 1;
+            }
+
+            if (i == 0 || times[i - 1] < 0.0)
+                continue;
+
+            if (times[i] >= times[i - 1])
+                crossovers[i] = 0;
+            else if (crossovers[i] == 0)
+                crossovers[i] = size;
+        }
+
+        std::printf("\n");
+    }
+
+    for (std::size_t i = 1; i < algorithmCount; ++i) {
+        std::printf(
+            "%s beats %s from %zu limbs\n",
+            algorithmNames[i],
+            algorithmNames[i - 1],
+            crossovers[i]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+// times every escape kernel of every instruction set the cpu supports on one
+// frame per fractal mode, kernels of the same exponent class and precision
+// are compared across lane modes and instruction sets
+//
+// usage: kernels_bench [width height maxIteration]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+#include "core/kernel.hpp"
+
+namespace {
+using namespace mandel::core;
+
+constexpr const char* laneModeNames[] = {"grouped", "refill"};
+constexpr const char* precisionNames[] = {"float", "double", "double-double"};
+constexpr const char* fractalModeNames[] = {"mandelbrot", "julia"};
+
+// exponent the polar class is timed with
+constexpr double polarExponent = 2.5;
+
+double getExponent(const std::size_t exponentClass) {
+    return exponentClass == polarExponentClass
+        ? polarExponent
+        : static_cast<double>(
+            minIntegerExponent + static_cast<int>(exponentClass));
+}
+
+// median time of one frame in milliseconds
+double timeKernel(
+    const escapeFunc kernel,
+    const kernelParams& params,
+    const std::vector<std::uint32_t>& pixels,
+    std::vector<int>& iterations) {
+    using clock = std::chrono::steady_clock;
+
+    std::vector<double> samples(3);
+
+    for (double& sample : samples) {
+        const auto start = clock::now();
+
+        kernel(params, pixels.data(), pixels.size(), iterations.data());
+
+        sample = std::chrono::duration<double, std::milli>(
+                     clock::now() - start)
+                     .count();
+    }
+
+    std::nth_element(samples.begin(), samples.begin() + 1, samples.end());
+
+    return samples[1];
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    int width = 256;
+    int height = 256;
+    int maxIteration = 256;
+
+    if (argc == 4) {
+        width = std::atoi(argv[1]);
+        height = std::atoi(argv[2]);
+        maxIteration = std::atoi(argv[3]);
+    }
+
+    if (width <= 0 || height <= 0 || maxIteration <= 0) {
+        std::printf("usage: %s [width height maxIteration]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<std::uint32_t> pixels(
+        static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
+    std::iota(pixels.begin(), pixels.end(), std::uint32_t(0));
+
+    std::vector<int> iterations(pixels.size());
+
+    std::vector<const kernelTable*> tables;
+
+    for (const isa set : {isa::scalar, isa::avx2, isa::avx512}) {
+        if (const kernelTable* table = GetKernels(set))
+            tables.push_back(table);
+    }
+
+    std::printf(
+        "%dx%d pixels, %d iterations, milliseconds per frame\n\n",
+        width,
+        height,
+        maxIteration);
+
+    std::printf("%-11s %-14s %8s", "fractal", "precision", "exponent");
+    for (const kernelTable* table : tables) {
+        for (const char* lanes : laneModeNames)
+            std::printf(" %9.9s/%-7.7s", table->name, lanes);
+    }
+    std::printf("\n");
+
+    for (std::size_t f = 0; f < std::size(fractalModeNames); ++f) {
+        const fractalMode fractal = static_cast<fractalMode>(f);
+
+        for (std::size_t p = 0; p < directPrecisionCount; ++p) {
+            for (std::size_t e = 0; e < exponentClassCount; ++e) {
+                // the whole frame of the default view
+                view v;
+                v.maxIteration = maxIteration;
+                v.increment = {
+                    4.0 / static_cast<double>(width),
+                    4.0 / static_cast<double>(height)};
+                v.bUseJuliaSet = fractal == fractalMode::julia;
+                v.juliaConstant = {-0.8, 0.156};
+                v.exponent = getExponent(e);
+
+                const kernelParams params = GetKernelParams(v, width, height);
+
+                std::printf(
+                    "%-11s %-14s %8.1f",
+                    fractalModeNames[f],
+                    precisionNames[p],
+                    v.exponent);
+
+                for (const kernelTable* table : tables) {
+                    for (std::size_t l = 0; l < std::size(laneModeNames); ++l) {
+                        const escapeFunc kernel = table->m_escape(
+                            static_cast<laneMode>(l),
+                            static_cast<precision>(p),
+                            fractal,
+                            e);
+
+                        std::printf(
+                            " %17.2f",
+                            timeKernel(kernel, params, pixels, iterations));
+                    }
+                }
+
+                std::printf("\n");
+                std::fflush(stdout);
+            }
+        }
+    }
+
+    return 0;
+}
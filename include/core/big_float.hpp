@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mandel::core {
+
+// arbitrary precision binary floating point number
+//
+// value = 0.limbs * 2^exponent, the limbs are little endian base 2^32 digits
+// and the top bit of the most significant limb is set unless the value is
+// zero, results are truncated towards zero to the larger precision of the
+// operands
+class bigFloat {
+  public:
+    static constexpr std::size_t s_defaultPrecision = 64;  // bits
+
+    bigFloat();
+    bigFloat(const double v, const std::size_t precision = s_defaultPrecision);
+
+    // bits of mantissa, always a multiple of 32
+    [[nodiscard]] std::size_t m_precision() const noexcept {
+        return m_limbs.size() * 32;
+    }
+
+    // extends with zeros or truncates the mantissa
+    void m_setPrecision(const std::size_t precision);
+
+    [[nodiscard]] bool m_isZero() const noexcept {
+        return m_zero;
+    }
+    [[nodiscard]] bool m_isNegative() const noexcept {
+        return m_negative;
+    }
+
+    // |value| is in [2^(exponent - 1), 2^exponent), 0 for zero
+    [[nodiscard]] std::int64_t m_exponent() const noexcept {
+        return m_zero ? 0 : m_exp;
+    }
+
+    // the mantissa, little endian base 2^32 digits
+    [[nodiscard]] const std::vector<std::uint32_t>& limbs() const noexcept {
+        return m_limbs;
+    }
+
+    // nearest double, 0 or inf when out of range
+    [[nodiscard]] double m_toDouble() const;
+
+    // value * 2^k
+    [[nodiscard]] bigFloat m_ldexp(const std::int64_t k) const;
+
+    // the largest whole number up to value, in the same precision
+    [[nodiscard]] bigFloat m_floor() const;
+
+    bigFloat operator-() const;
+
+    friend bigFloat operator+(const bigFloat& a, const bigFloat& b);
+    friend bigFloat operator-(const bigFloat& a, const bigFloat& b);
+    friend bigFloat operator*(const bigFloat& a, const bigFloat& b);
+
+    bigFloat& operator+=(const bigFloat& b) {
+        return *this = *this + b;
+    }
+    bigFloat& operator-=(const bigFloat& b) {
+        return *this = *this - b;
+    }
+    bigFloat& operator*=(const bigFloat& b) {
+        return *this = *this * b;
+    }
+
+    friend bool operator==(const bigFloat& a, const bigFloat& b);
+    friend bool operator<(const bigFloat& a, const bigFloat& b);
+
+    friend bool operator!=(const bigFloat& a, const bigFloat& b) {
+        return !(a == b);
+    }
+    friend bool operator>(const bigFloat& a, const bigFloat& b) {
+        return b < a;
+    }
+    friend bool operator<=(const bigFloat& a, const bigFloat& b) {
+        return !(b < a);
+    }
+    friend bool operator>=(const bigFloat& a, const bigFloat& b) {
+        return !(a < b);
+    }
+
+  private:
+    static bigFloat s_addMagnitudes(
+        const bigFloat& a,
+        const bigFloat& b,
+        const bool negative);
+    static bigFloat s_subMagnitudes(
+        const bigFloat& a,
+        const bigFloat& b,
+        const bool negative);
+
+    // -1, 0, 1 for |a| < |b|, |a| == |b|, |a| > |b|
+    static int s_compareMagnitudes(const bigFloat& a, const bigFloat& b);
+
+    std::vector<std::uint32_t> m_limbs;
+    std::int64_t m_exp = 0;
+    bool m_negative = false;
+    bool m_zero = true;
+};
+
+// a point of the complex plane in arbitrary precision
+struct bigVec2 {
+    bigFloat x, y;
+};
+
+}  // namespace mandel::core
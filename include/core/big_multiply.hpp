@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mandel::core {
+
+// algorithms MultiplyLimbs picks from by operand size
+enum class multiplyAlgorithm {
+    schoolbook,
+    karatsuba,
+    // number theoretic transform over two primes, 16 bit digits
+    ntt,
+    count
+};
+
+// limb counts from which karatsuba and the ntt take over, where
+// bench/big_multiply.cpp measured the crossovers
+constexpr std::size_t karatsubaThreshold = 48;
+constexpr std::size_t nttThreshold = 8192;
+
+// the algorithm MultiplyLimbs uses for operands of sizeA and sizeB limbs
+multiplyAlgorithm GetMultiplyAlgorithm(
+    const std::size_t sizeA,
+    const std::size_t sizeB);
+
+// product of the little endian base 2^32 numbers a and b, product has to
+// hold sizeA + sizeB limbs and must not overlap a or b
+void MultiplyLimbs(
+    const std::uint32_t* a,
+    const std::size_t sizeA,
+    const std::uint32_t* b,
+    const std::size_t sizeB,
+    std::uint32_t* product);
+
+// MultiplyLimbs with a fixed algorithm, karatsuba and the ntt still fall
+// back to schoolbook on the small pieces
+void MultiplyLimbs(
+    const multiplyAlgorithm algorithm,
+    const std::uint32_t* a,
+    const std::size_t sizeA,
+    const std::uint32_t* b,
+    const std::size_t sizeB,
+    std::uint32_t* product);
+
+}  // namespace mandel::core
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "core/reference_orbit.hpp"
+
+namespace mandel::core {
+
+// bivariate linear approximation of 2^level perturbation iterations,
+// delta_(k + length) = a delta_k + b delta_c as long as |delta_k| < r
+struct blaStep {
+    double ax, ay;
+    double bx, by;
+    // r^2, negative when the step can not be taken at all
+    double r2;
+};
+
+// bla steps on top of a reference orbit, a pixel at orbit index k with k a
+// multiple of 2^level can jump to k + 2^level with levels[level - 1][k >>
+// level], the single iteration level is not stored as a plain perturbation
+// iteration is just as cheap
+//
+// steps never cross the end of the start or the rebase orbit
+struct blaTable {
+    std::vector<std::vector<blaStep>> levels;
+
+    [[nodiscard]] bool m_isEmpty() const noexcept {
+        return levels.empty();
+    }
+};
+
+// builds the table for orbit, maxDeltaC is the largest |delta_c| of the
+// frame, 0 for julia sets where delta_c is always 0
+void ComputeBlaTable(
+    const referenceOrbit& orbit,
+    const double maxDeltaC,
+    blaTable& table);
+
+}  // namespace mandel::core
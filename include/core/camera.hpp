@@ -0,0 +1,78 @@
+#pragma once
+
+#include "core/big_float.hpp"
+#include "core/view.hpp"
+#include "vec4.hpp"
+
+namespace mandel::core {
+
+// screen center and pixel spacing in arbitrary precision, panning and
+// zooming only ever add exact offsets so the location does not drift no
+// matter how deep the zoom goes
+//
+// positions on the screen are in pixels with (0, 0) at the top left
+class camera {
+  public:
+    camera();
+
+    // center at 0 with worldSpace visible on the screen
+    void m_reset(const vec4<double> worldSpace, const vec4<double> screenSize);
+
+    // keeps the visible world size when the screen size changes
+    void m_resize(
+        const vec4<double> oldScreenSize,
+        const vec4<double> newScreenSize);
+
+    // move the set by movement pixels
+    void m_move(const vec4<double> movement);
+
+    // scale the pixel spacing by zoomFactor, the point under mousePos stays
+    // where it is
+    void m_zoom(
+        const double zoomFactor,
+        const vec4<double> mousePos,
+        const vec4<double> screenSize);
+
+    void m_setAngle(const double angle);
+
+    [[nodiscard]] const bigVec2& position() const noexcept {
+        return m_position;
+    }
+    [[nodiscard]] const bigFloat& increment() const noexcept {
+        return m_increment;
+    }
+    [[nodiscard]] double angle() const noexcept {
+        return m_angle;
+    }
+
+    // rotation vector (cos, sin)
+    [[nodiscard]] vec4<double> rotation() const noexcept {
+        return m_rotation;
+    }
+
+    // the position rounded to double, what a float or double kernel sees
+    [[nodiscard]] vec4<double> m_getStartPos() const;
+    [[nodiscard]] double m_getIncrement() const;
+
+    // copies the camera into the position, spacing and rotation of v, past
+    // the range of double the spacing goes with an increment scale
+    void m_apply(view& v) const;
+
+  private:
+    // rotate a vector in pixels by the rotation
+    vec4<double> m_getRotated(const vec4<double> vec) const;
+
+    // position += offset * increment
+    void m_offset(const vec4<double> offset);
+
+    // enough bits for the position to resolve a fraction of a pixel
+    void m_updatePrecision();
+
+    bigVec2 m_position;
+    bigFloat m_increment;
+
+    double m_angle = 0.0;
+    vec4<double> m_rotation {1.0, 0.0};
+};
+
+}  // namespace mandel::core
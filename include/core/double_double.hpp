@@ -0,0 +1,86 @@
+#pragma once
+
+// double-double arithmetic on the simd wrappers, a value is the unevaluated
+// sum hi + lo with |lo| <= ulp(hi) / 2 which gives about 106 bits of
+// mantissa
+//
+// everything is built from the error free transformations of Knuth (two
+// sum) and of the fused multiply (two prod), so it needs FMSub to be exact,
+// like simd.hpp it can only be included by a kernel translation unit
+
+#include "core/simd.hpp"
+
+namespace mandel::core::MANDEL_KERNEL_ISA::dd {
+
+template<typename V>
+struct doubleDouble {
+    V hi, lo;
+};
+
+// a + b = s + e exactly
+template<typename V>
+inline doubleDouble<V> TwoSum(const V a, const V b) {
+    const V s = a + b;
+    const V bb = s - a;
+
+    return {s, (a - (s - bb)) + (b - bb)};
+}
+
+// TwoSum for |a| >= |b|
+template<typename V>
+inline doubleDouble<V> QuickTwoSum(const V a, const V b) {
+    const V s = a + b;
+
+    return {s, b - (s - a)};
+}
+
+// a * b = p + e exactly
+template<typename V>
+inline doubleDouble<V> TwoProd(const V a, const V b) {
+    const V p = a * b;
+
+    return {p, simd::FMSub(a, b, p)};
+}
+
+// the sloppy addition, its error is relative to |a| + |b| instead of
+// |a + b| which is all an escape loop on values around 2 needs
+template<typename V>
+inline doubleDouble<V>
+operator+(const doubleDouble<V> a, const doubleDouble<V> b) {
+    const doubleDouble<V> s = TwoSum(a.hi, b.hi);
+
+    return QuickTwoSum(s.hi, s.lo + (a.lo + b.lo));
+}
+
+template<typename V>
+inline doubleDouble<V>
+operator-(const doubleDouble<V> a, const doubleDouble<V> b) {
+    const doubleDouble<V> s = TwoSum(a.hi, V::s_broadcast(0) - b.hi);
+
+    return QuickTwoSum(s.hi, s.lo + (a.lo - b.lo));
+}
+
+template<typename V>
+inline doubleDouble<V>
+operator*(const doubleDouble<V> a, const doubleDouble<V> b) {
+    const doubleDouble<V> p = TwoProd(a.hi, b.hi);
+
+    return QuickTwoSum(
+        p.hi,
+        simd::FMAdd(a.hi, b.lo, simd::FMAdd(a.lo, b.hi, p.lo)));
+}
+
+template<typename V>
+inline doubleDouble<V> Square(const doubleDouble<V> a) {
+    const doubleDouble<V> p = TwoProd(a.hi, a.hi);
+
+    return QuickTwoSum(p.hi, simd::FMAdd(a.hi + a.hi, a.lo, p.lo));
+}
+
+// 2 * a, exact
+template<typename V>
+inline doubleDouble<V> Twice(const doubleDouble<V> a) {
+    return {a.hi + a.hi, a.lo + a.lo};
+}
+
+}  // namespace mandel::core::MANDEL_KERNEL_ISA::dd
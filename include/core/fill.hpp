@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/render.hpp"
+
+namespace mandel::core {
+
+// pixels [x0, x1) x [y0, y1) of a frame
+struct pixelRect {
+    int x0, y0;
+    int x1, y1;
+};
+
+struct fillStats {
+    // pixels the kernel ran for, the others were filled in
+    std::size_t computedPixels = 0;
+    // of them the ones periodicity detection stopped early
+    std::size_t periodicPixels = 0;
+};
+
+// computes the iterations of the pixels of rect with mode, iterations is the
+// row major frame of width, pixels is scratch space kept by the caller to
+// reuse its allocation
+//
+// fillMode::boundaryTrace only fills regions inside the set when the
+// kernel sets kernelParams::zX, whose nan marks the pixels caught in a
+// cycle, so it must not hold nan for the pixels of rect before
+fillStats FillRect(
+    const frameKernel& kernel,
+    const fillMode mode,
+    const int width,
+    const pixelRect& rect,
+    int* iterations,
+    std::vector<std::uint32_t>& pixels);
+
+}  // namespace mandel::core
@@ -0,0 +1,169 @@
+#pragma once
+
+// a double mantissa with an exponent of its own, value = mantissa *
+// 2^exponent with |mantissa| in [1, 2) or 0, for perturbation deltas of
+// zooms past the range of double where every pixel would otherwise need
+// arbitrary precision
+//
+// both parts are plain doubles and normalizing only touches the exponent
+// bits, so there are no calls to frexp or ldexp and no branches beyond the
+// zero checks, like simd.hpp it can only be included by a kernel
+// translation unit
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace mandel::core::MANDEL_KERNEL_ISA {
+
+class floatExp {
+  public:
+    floatExp() = default;
+
+    // implicit so doubles mix in freely
+    floatExp(const double v) : m_mantissa(v) {
+        m_normalize();
+    }
+
+    // value * 2^k
+    [[nodiscard]] floatExp m_ldexp(const double k) const {
+        floatExp result = *this;
+
+        if (m_mantissa != 0.0)
+            result.m_exponent += k;
+
+        return result;
+    }
+
+    // nearest double, 0 or inf when out of range
+    [[nodiscard]] double m_toDouble() const {
+        return std::ldexp(m_mantissa, static_cast<int>(m_clampedExponent()));
+    }
+
+    // exponent of the value, -inf for zero
+    [[nodiscard]] double m_log2() const {
+        return m_mantissa == 0.0
+            ? -std::numeric_limits<double>::infinity()
+            : m_exponent;
+    }
+
+    floatExp operator-() const {
+        floatExp result = *this;
+        result.m_mantissa = -m_mantissa;
+
+        return result;
+    }
+
+    friend floatExp operator*(const floatExp a, const floatExp b) {
+        floatExp result;
+        result.m_mantissa = a.m_mantissa * b.m_mantissa;
+        result.m_exponent = a.m_exponent + b.m_exponent;
+        result.m_normalize();
+
+        return result;
+    }
+
+    friend floatExp operator+(const floatExp a, const floatExp b) {
+        // the smaller one is scaled down to the exponent of the larger
+        // one, past 64 bits apart it does not change the sum anymore
+        const bool bSwap = a.m_exponent < b.m_exponent;
+
+        const floatExp& big = bSwap ? b : a;
+        const floatExp& small = bSwap ? a : b;
+
+        if (small.m_mantissa == 0.0)
+            return big;
+        if (big.m_mantissa == 0.0)
+            return small;
+
+        const double shift = small.m_exponent - big.m_exponent;
+
+        if (shift < -64.0)
+            return big;
+
+        floatExp result;
+        result.m_mantissa = big.m_mantissa + small.m_mantissa * s_pow2(shift);
+        result.m_exponent = big.m_exponent;
+        result.m_normalize();
+
+        return result;
+    }
+
+    friend floatExp operator-(const floatExp a, const floatExp b) {
+        return a + -b;
+    }
+
+    floatExp& operator+=(const floatExp b) {
+        return *this = *this + b;
+    }
+    floatExp& operator*=(const floatExp b) {
+        return *this = *this * b;
+    }
+
+    friend bool operator<(const floatExp a, const floatExp b) {
+        return (a - b).m_mantissa < 0.0;
+    }
+    friend bool operator>(const floatExp a, const floatExp b) {
+        return b < a;
+    }
+    friend bool operator<=(const floatExp a, const floatExp b) {
+        return !(b < a);
+    }
+    friend bool operator>=(const floatExp a, const floatExp b) {
+        return !(a < b);
+    }
+
+  private:
+    // 2^k for a whole k in the normal range of double
+    static double s_pow2(const double k) {
+        const std::uint64_t bits = static_cast<std::uint64_t>(
+                                       static_cast<std::int64_t>(k) + 1023)
+            << 52;
+
+        double result;
+        std::memcpy(&result, &bits, sizeof(result));
+
+        return result;
+    }
+
+    // the exponent clamped to what ldexp of a double can still round
+    double m_clampedExponent() const {
+        return m_exponent < -1100.0 ? -1100.0
+            : m_exponent > 1100.0   ? 1100.0
+                                    : m_exponent;
+    }
+
+    // moves the exponent bits of the mantissa into the exponent, the
+    // mantissa has to be a normal double or 0
+    void m_normalize() {
+        std::uint64_t bits;
+        std::memcpy(&bits, &m_mantissa, sizeof(bits));
+
+        const std::uint64_t biased = (bits >> 52) & 0x7ff;
+
+        if (biased == 0) {
+            // zero, or a subnormal that is scaled up first
+            if (m_mantissa == 0.0) {
+                m_exponent = 0.0;
+                return;
+            }
+
+            m_mantissa *= 0x1p64;
+            m_exponent -= 64.0;
+            m_normalize();
+            return;
+        }
+
+        m_exponent += static_cast<double>(biased) - 1023.0;
+
+        bits = (bits & ~(std::uint64_t(0x7ff) << 52))
+            | (std::uint64_t(1023) << 52);
+        std::memcpy(&m_mantissa, &bits, sizeof(bits));
+    }
+
+    double m_mantissa = 0.0;
+    double m_exponent = 0.0;
+};
+
+}  // namespace mandel::core::MANDEL_KERNEL_ISA
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "core/perturbation.hpp"
+#include "core/view.hpp"
+
+namespace mandel::core {
+
+// floating point type the escape loop runs in
+enum class precision {
+    singleFloat,
+    doubleFloat,
+    // double-double, about 106 bits for zooms down to 1e-30
+    doubleDouble,
+    // double deltas from an arbitrary precision reference orbit
+    perturbation
+};
+
+// precisions with a direct escape kernel, every one before perturbation
+constexpr std::size_t directPrecisionCount =
+    static_cast<std::size_t>(precision::perturbation);
+
+// how the vector lanes are fed with pixels
+enum class laneMode {
+    // a group of pixels runs until its slowest lane is done
+    grouped,
+    // finished lanes load the next pending pixel right away
+    refill,
+    count
+};
+
+// instruction sets the kernels are compiled for
+enum class isa { scalar, avx2, avx512 };
+
+// the set a kernel draws, julia pixels start at z = pixel with a fixed c and
+// mandelbrot pixels at z = c = pixel
+enum class fractalMode { mandelbrot, julia, count };
+
+// whole exponents with a kernel of their own, every other exponent runs
+// the polar form of SetCurrentExponent
+constexpr int minIntegerExponent = -8;
+constexpr int maxIntegerExponent = 8;
+
+// one exponent class per whole exponent in range and a last one for the
+// polar form
+constexpr std::size_t exponentClassCount =
+    static_cast<std::size_t>(maxIntegerExponent - minIntegerExponent) + 2;
+constexpr std::size_t polarExponentClass = exponentClassCount - 1;
+
+// the exponent class of the kernels that run exponent
+std::size_t GetExponentClass(const double exponent);
+
+// per frame constants of the escape loop
+struct kernelParams {
+    // complex plane location of the lattice point the pixels are counted
+    // from, rotation is already applied
+    double originX, originY;
+    // what is left of the origin after rounding it to double, only the
+    // double-double kernels read it
+    double originXLo, originYLo;
+    // pixel (0, 0) in steps from the origin, pixel (x, y) is at
+    // origin + (pixelX + x) stepX + (pixelY + y) stepY
+    double pixelX, pixelY;
+    // complex plane step per pixel on the x and y axes
+    double stepXx, stepXy;
+    double stepYx, stepYy;
+
+    int width;
+    int maxIteration;
+
+    bool bUseJuliaSet;
+    double juliaX, juliaY;
+
+    double exponent;
+
+    // the origin and steps of perturbation kernels are in units of
+    // 2^deltaScale, 0 unless the zoom is past the range of double
+    int deltaScale = 0;
+
+    // perturbation kernels write glitchedIteration for pixels whose delta
+    // lost track of the reference instead of rebasing them
+    bool bDetectGlitches = false;
+
+    // escape kernels give maxIteration to a pixel whose z comes back this
+    // close to an earlier z, it is caught in an attracting cycle
+    double periodicityTolerance = 0.0;
+
+    // when set, the refill kernels of float and double write the z of every
+    // pixel that stops at maxIteration to zX[pixel] and zY[pixel], nan to
+    // zX of one caught in a cycle or inside the main bulbs, and with
+    // bResume pixels start from there at the count iterations holds for
+    // them instead of at the pixel, to continue a frame of a lower
+    // maxIteration
+    double* zX = nullptr;
+    double* zY = nullptr;
+    bool bResume = false;
+};
+
+// iteration count of a glitched perturbation pixel
+constexpr int glitchedIteration = -1;
+
+// with a reference the origin is relative to it, for perturbation kernels,
+// the direct kernels can not draw a view with an incrementScale
+//
+// the pixels of every frame of an increment and rotation are points of one
+// lattice, counted from a corner of it near the frame, so a frame moved by
+// whole pixels computes the points of the frame before at the same
+// rounding, the lattice moves a frame by up to 1 / 2048 of a pixel
+kernelParams GetKernelParams(
+    const view& v,
+    const int width,
+    const int height,
+    const bigVec2* reference = nullptr);
+
+// computes the iteration count of count pixels, pixels holds row major
+// indices into the frame and the results are written to iterations[pixel],
+// returns how many of them periodicity detection stopped early
+using escapeFunc = std::size_t (*)(
+    const kernelParams& params,
+    const std::uint32_t* pixels,
+    const std::size_t count,
+    int* iterations);
+
+// same as escapeFunc with every pixel iterated as a double delta from the
+// reference orbit of state, exponent 2 only
+//
+// pixels start at the skip of the series and jump along the orbit with the
+// steps of the bla table, when state has them
+using perturbFunc = void (*)(
+    const kernelParams& params,
+    const perturbationState& state,
+    const std::uint32_t* pixels,
+    const std::size_t count,
+    int* iterations);
+
+// every kernel of an instruction set, the mode, exponent and precision are
+// template parameters of the escape loops so nothing but the pixels is
+// decided inside of them, frames pick theirs once and benchmarks can walk
+// the whole table
+struct kernelTable {
+    isa set;
+    const char* name;
+
+    // indexed by laneMode, precision, fractalMode and exponent class,
+    // double-double lanes are always refilled and only exponent 2 has
+    // double-double kernels, the other classes hold the double ones
+    escapeFunc escape[static_cast<std::size_t>(laneMode::count)]
+                     [directPrecisionCount]
+                     [static_cast<std::size_t>(fractalMode::count)]
+                     [exponentClassCount];
+
+    // lanes are always refilled
+    perturbFunc perturb;
+
+    escapeFunc m_escape(
+        const laneMode mode,
+        const precision p,
+        const fractalMode fractal,
+        const std::size_t exponentClass) const {
+        return escape[static_cast<std::size_t>(mode)]
+                     [static_cast<std::size_t>(p)]
+                     [static_cast<std::size_t>(fractal)][exponentClass];
+    }
+
+    // the kernel for the mode and exponent of params
+    escapeFunc m_escape(
+        const laneMode mode,
+        const precision p,
+        const kernelParams& params) const {
+        return m_escape(
+            mode,
+            p,
+            params.bUseJuliaSet ? fractalMode::julia : fractalMode::mandelbrot,
+            GetExponentClass(params.exponent));
+    }
+};
+
+// kernels of the widest instruction set the cpu supports, picked once
+const kernelTable& GetKernels();
+
+// nullptr if the cpu or the build does not support the instruction set
+const kernelTable* GetKernels(const isa set);
+
+// defined by the kernel translation units, nullptr when not compiled in
+const kernelTable* GetScalarKernels();
+const kernelTable* GetAvx2Kernels();
+const kernelTable* GetAvx512Kernels();
+
+}  // namespace mandel::core
@@ -0,0 +1,1358 @@
+#pragma once
+
+// escape loop templates, included once by every kernel translation unit
+// after it defines MANDEL_KERNEL_ISA
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+#include "core/double_double.hpp"
+#include "core/float_exp.hpp"
+#include "core/kernel.hpp"
+#include "core/simd.hpp"
+#include "core/simd_math.hpp"
+
+namespace mandel::core::MANDEL_KERNEL_ISA {
+
+inline int countTrailingZeros(const unsigned bits) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(bits);
+#endif
+}
+
+// complex plane location of a row major pixel index
+template<typename T>
+inline void getPixelLocation(
+    const kernelParams& p,
+    const std::uint32_t pixel,
+    T& x,
+    T& y) {
+    const std::uint32_t width = static_cast<std::uint32_t>(p.width);
+
+    const double px = p.pixelX + static_cast<double>(pixel % width);
+    const double py = p.pixelY + static_cast<double>(pixel / width);
+
+    x = static_cast<T>(p.originX + px * p.stepXx + py * p.stepYx);
+    y = static_cast<T>(p.originY + px * p.stepXy + py * p.stepYy);
+}
+
+// getPixelLocation in double-double, the offset from the origin is small
+// enough for a double
+inline void getPixelLocation(
+    const kernelParams& p,
+    const std::uint32_t pixel,
+    dd::doubleDouble<simd::scalarVec<double>>& x,
+    dd::doubleDouble<simd::scalarVec<double>>& y) {
+    using scalar = simd::scalarVec<double>;
+
+    const std::uint32_t width = static_cast<std::uint32_t>(p.width);
+
+    const double px = p.pixelX + static_cast<double>(pixel % width);
+    const double py = p.pixelY + static_cast<double>(pixel / width);
+
+    x = dd::doubleDouble<scalar> {{p.originX}, {p.originXLo}}
+        + dd::doubleDouble<scalar> {{px * p.stepXx + py * p.stepYx}, {0.0}};
+    y = dd::doubleDouble<scalar> {{p.originY}, {p.originYLo}}
+        + dd::doubleDouble<scalar> {{px * p.stepXy + py * p.stepYy}, {0.0}};
+}
+
+// z^n of x + iy for a whole n, x2 and y2 are x^2 and y^2, the powers are
+// unrolled at compile time into squarings and multiplications by z and a
+// negative n takes one reciprocal at the end
+template<int n, typename V>
+inline void complexPower(
+    const V x,
+    const V y,
+    const V x2,
+    const V y2,
+    V& px,
+    V& py) {
+    if constexpr (n < 0) {
+        V ax, ay;
+        complexPower<-n>(x, y, x2, y2, ax, ay);
+
+        const V scale = V::s_broadcast(1) / (ax * ax + ay * ay);
+
+        px = ax * scale;
+        py = (V::s_broadcast(0) - ay) * scale;
+    } else if constexpr (n == 0) {
+        px = V::s_broadcast(1);
+        py = V::s_broadcast(0);
+    } else if constexpr (n == 1) {
+        px = x;
+        py = y;
+    } else if constexpr (n == 2) {
+        px = x2 - y2;
+        py = (x + x) * y;
+    } else if constexpr (n % 2 == 0) {
+        V ax, ay;
+        complexPower<n / 2>(x, y, x2, y2, ax, ay);
+
+        px = ax * ax - ay * ay;
+        py = (ax + ax) * ay;
+    } else {
+        V ax, ay;
+        complexPower<n - 1>(x, y, x2, y2, ax, ay);
+
+        px = ax * x - ay * y;
+        py = simd::FMAdd(ax, y, ay * x);
+    }
+}
+
+// z = z^n + c for a whole n
+template<int n>
+struct integerStep {
+    explicit integerStep(const kernelParams&) {}
+
+    template<typename V>
+    void m_apply(
+        V& x,
+        V& y,
+        const V x2,
+        const V y2,
+        const V cx,
+        const V cy) const {
+        if constexpr (n == 2) {
+            // SetCurrent of fragment.glsl
+            y = simd::FMAdd(x + x, y, cy);
+            x = x2 - y2 + cx;
+        } else {
+            V px, py;
+            complexPower<n>(x, y, x2, y2, px, py);
+
+            x = px + cx;
+            y = py + cy;
+        }
+    }
+};
+
+// z = |z|^n (cos n arg z + i sin n arg z) + c, SetCurrentExponent of
+// fragment.glsl for the exponents that are not whole
+struct polarStep {
+    explicit polarStep(const kernelParams& p) : m_exponent(p.exponent) {}
+
+    template<typename V>
+    void m_apply(
+        V& x,
+        V& y,
+        const V x2,
+        const V y2,
+        const V cx,
+        const V cy) const {
+        //https://en.wikipedia.org/wiki/Multibrot_set
+        simd::PolarStep(
+            x,
+            y,
+            x2 + y2,
+            cx,
+            cy,
+            V::s_broadcast(static_cast<typename V::value_type>(m_exponent)));
+    }
+
+    double m_exponent;
+};
+
+// the exponent 2 mandelbrot set contains the main cardioid and the period 2
+// bulb in closed form, pixels inside them get maxIteration before the loop
+//https://en.wikipedia.org/wiki/Plotting_algorithms_for_the_Mandelbrot_set#Cardioid_/_bulb_checking
+template<fractalMode fractal, typename step>
+constexpr bool bSkipMainBulbs =
+    fractal == fractalMode::mandelbrot && std::is_same_v<step, integerStep<2>>;
+
+// false for c inside the main cardioid or the period 2 bulb
+template<typename V>
+inline typename V::mask isOutsideMainBulbs(const V x, const V y) {
+    using T = typename V::value_type;
+
+    const V y2 = y * y;
+
+    const V cardioidX = x - V::s_broadcast(T(0.25));
+    const V q = cardioidX * cardioidX + y2;
+
+    const V bulbX = x + V::s_broadcast(T(1));
+
+    return (q * (q + cardioidX) > V::s_broadcast(T(0.25)) * y2)
+        & (bulbX * bulbX + y2 > V::s_broadcast(T(0.0625)));
+}
+
+// SetCurrent of fragment.glsl on unroll vectors at once, lanes past the end
+// of pixels repeat the last pixel and their results are dropped, step is
+// one of the step types above
+//
+// z is saved at every power of 2 iteration and a lane that comes back within
+// periodicityTolerance of it is in a cycle and gets maxIteration, brent's
+// cycle detection, returns how many pixels that stopped
+template<typename V, std::size_t unroll, fractalMode fractal, typename step>
+std::size_t escapeGroups(
+    const kernelParams& p,
+    const std::uint32_t* pixels,
+    const std::size_t count,
+    int* iterations) {
+    using T = typename V::value_type;
+    using mask = typename V::mask;
+
+    constexpr std::size_t lanes = V::width * unroll;
+
+    alignas(64) T xs[lanes];
+    alignas(64) T ys[lanes];
+
+    const V zero = V::s_broadcast(T(0));
+    const V one = V::s_broadcast(T(1));
+    const V four = V::s_broadcast(T(4));
+    const V infinity = V::s_broadcast(std::numeric_limits<T>::infinity());
+    const V tolerance = V::s_broadcast(
+        static_cast<T>(p.periodicityTolerance * p.periodicityTolerance));
+
+    const V juliaX = V::s_broadcast(static_cast<T>(p.juliaX));
+    const V juliaY = V::s_broadcast(static_cast<T>(p.juliaY));
+    const V maxIteration = V::s_broadcast(static_cast<T>(p.maxIteration));
+
+    const step formula(p);
+
+    std::size_t periodicPixels = 0;
+
+    for (std::size_t start = 0; start < count; start += lanes) {
+        const std::size_t n = std::min(lanes, count - start);
+
+        for (std::size_t l = 0; l < lanes; ++l) {
+            const std::uint32_t pixel = pixels[start + std::min(l, n - 1)];
+            getPixelLocation(p, pixel, xs[l], ys[l]);
+        }
+
+        V x[unroll], y[unroll], cx[unroll], cy[unroll], counter[unroll];
+        V saveX[unroll], saveY[unroll];
+        mask active[unroll];
+        unsigned periodic[unroll];
+
+        for (std::size_t u = 0; u < unroll; ++u) {
+            x[u] = V::s_load(xs + u * V::width);
+            y[u] = V::s_load(ys + u * V::width);
+
+            saveX[u] = saveY[u] = infinity;
+            periodic[u] = 0;
+
+            if constexpr (fractal == fractalMode::julia) {
+                cx[u] = juliaX;
+                cy[u] = juliaY;
+            } else {
+                cx[u] = x[u];
+                cy[u] = y[u];
+            }
+
+            if constexpr (bSkipMainBulbs<fractal, step>) {
+                active[u] = isOutsideMainBulbs(x[u], y[u]);
+                counter[u] = simd::Select(active[u], zero, maxIteration);
+            } else {
+                counter[u] = zero;
+                active[u] = zero <= zero;  // every lane
+            }
+        }
+
+        for (int i = 0; i < p.maxIteration; ++i) {
+            bool anyActive = false;
+
+            V x2[unroll], y2[unroll];
+
+            for (std::size_t u = 0; u < unroll; ++u) {
+                x2[u] = x[u] * x[u];
+                y2[u] = y[u] * y[u];
+
+                // escaped lanes stay escaped and keep their last z
+                active[u] = active[u] & (x2[u] + y2[u] <= four);
+
+                const V dx = x[u] - saveX[u];
+                const V dy = y[u] - saveY[u];
+                const V d2 = dx * dx + dy * dy;
+
+                const mask cycle = active[u] & (d2 <= tolerance);
+
+                counter[u] = simd::Select(cycle, maxIteration, counter[u]);
+                active[u] = active[u] & (d2 > tolerance);
+                periodic[u] |= simd::MoveMask(cycle);
+
+                anyActive = simd::Any(active[u]) || anyActive;
+            }
+
+            if (!anyActive)
+                break;
+
+            const bool bSave = (i & (i - 1)) == 0;
+
+            for (std::size_t u = 0; u < unroll; ++u) {
+                if (bSave) {
+                    saveX[u] = x[u];
+                    saveY[u] = y[u];
+                }
+
+                counter[u] = simd::AddIf(active[u], counter[u], one);
+
+                V newX = x[u], newY = y[u];
+                formula.m_apply(newX, newY, x2[u], y2[u], cx[u], cy[u]);
+
+                x[u] = simd::Select(active[u], newX, x[u]);
+                y[u] = simd::Select(active[u], newY, y[u]);
+            }
+        }
+
+        for (std::size_t u = 0; u < unroll; ++u) {
+            simd::Store(xs + u * V::width, counter[u]);
+
+            for (unsigned bits = periodic[u]; bits != 0; bits &= bits - 1) {
+                const std::size_t l = u * V::width
+                    + static_cast<std::size_t>(countTrailingZeros(bits));
+
+                if (l < n)
+                    ++periodicPixels;
+            }
+        }
+
+        for (std::size_t l = 0; l < n; ++l)
+            iterations[pixels[start + l]] = static_cast<int>(xs[l]);
+    }
+
+    return periodicPixels;
+}
+
+// SetCurrent of fragment.glsl with lane refilling, every lane owns a pixel
+// of the queue and as soon as it escapes, hits maxIteration or is caught in
+// a cycle its result is retired and the lane loads the next pending pixel,
+// so the vectors stay full until the queue runs dry
+//
+// cycles are found like in escapeGroups, every lane saves z at the power of
+// 2 values of its own counter
+template<typename V, std::size_t unroll, fractalMode fractal, typename step>
+std::size_t escapeRefill(
+    const kernelParams& p,
+    const std::uint32_t* pixels,
+    const std::size_t count,
+    int* iterations) {
+    using T = typename V::value_type;
+    using mask = typename V::mask;
+
+    constexpr std::size_t lanes = V::width * unroll;
+    constexpr std::uint32_t emptyLane = ~std::uint32_t(0);
+
+    // lane state in structure of arrays layout, z is saved when the counter
+    // passes saveAt
+    alignas(64) T xs[lanes];
+    alignas(64) T ys[lanes];
+    alignas(64) T cxs[lanes];
+    alignas(64) T cys[lanes];
+    alignas(64) T counters[lanes];
+    alignas(64) T saveXs[lanes];
+    alignas(64) T saveYs[lanes];
+    alignas(64) T saveAts[lanes];
+    std::uint32_t lanePixels[lanes];
+
+    std::size_t next = 0;
+    std::size_t live = 0;
+    std::size_t periodicPixels = 0;
+
+    // put the next pixel of the queue into a lane, or park it when the
+    // queue is empty: z = 1 with c = 0 stays at 1 for every exponent and the
+    // counter never reaches maxIteration so a parked lane is never retired
+    // again
+    const auto loadLane = [&](const std::size_t l) {
+        while (next < count) {
+            const std::uint32_t pixel = pixels[next++];
+            getPixelLocation(p, pixel, xs[l], ys[l]);
+
+            if constexpr (bSkipMainBulbs<fractal, step>) {
+                using scalar = simd::scalarVec<T>;
+
+                if (!isOutsideMainBulbs(scalar {xs[l]}, scalar {ys[l]})) {
+                    iterations[pixel] = p.maxIteration;
+
+                    if (p.zX != nullptr) {
+                        p.zX[pixel] = std::numeric_limits<double>::quiet_NaN();
+                    }
+
+                    continue;
+                }
+            }
+
+            if constexpr (fractal == fractalMode::julia) {
+                cxs[l] = static_cast<T>(p.juliaX);
+                cys[l] = static_cast<T>(p.juliaY);
+            } else {
+                cxs[l] = xs[l];
+                cys[l] = ys[l];
+            }
+
+            if (p.bResume) {
+                xs[l] = static_cast<T>(p.zX[pixel]);
+                ys[l] = static_cast<T>(p.zY[pixel]);
+                counters[l] = static_cast<T>(iterations[pixel]);
+            } else {
+                counters[l] = T(0);
+            }
+            saveXs[l] = saveYs[l] = std::numeric_limits<T>::infinity();
+            saveAts[l] = T(0.5);
+            lanePixels[l] = pixel;
+            ++live;
+
+            return;
+        }
+
+        xs[l] = T(1);
+        ys[l] = cxs[l] = cys[l] = T(0);
+        counters[l] = -std::numeric_limits<T>::infinity();
+        saveXs[l] = saveYs[l] = std::numeric_limits<T>::infinity();
+        saveAts[l] = T(0.5);
+        lanePixels[l] = emptyLane;
+    };
+
+    for (std::size_t l = 0; l < lanes; ++l)
+        loadLane(l);
+
+    const V half = V::s_broadcast(T(0.5));
+    const V one = V::s_broadcast(T(1));
+    const V four = V::s_broadcast(T(4));
+    // counters are whole numbers
+    const V maxIteration =
+        V::s_broadcast(static_cast<T>(p.maxIteration) - T(0.5));
+    const V tolerance = V::s_broadcast(
+        static_cast<T>(p.periodicityTolerance * p.periodicityTolerance));
+
+    const step formula(p);
+
+    V x[unroll], y[unroll], cx[unroll], cy[unroll], counter[unroll];
+    V saveX[unroll], saveY[unroll], saveAt[unroll];
+
+    const auto loadVectors = [&]() {
+        for (std::size_t u = 0; u < unroll; ++u) {
+            x[u] = V::s_load(xs + u * V::width);
+            y[u] = V::s_load(ys + u * V::width);
+            cx[u] = V::s_load(cxs + u * V::width);
+            cy[u] = V::s_load(cys + u * V::width);
+            counter[u] = V::s_load(counters + u * V::width);
+            saveX[u] = V::s_load(saveXs + u * V::width);
+            saveY[u] = V::s_load(saveYs + u * V::width);
+            saveAt[u] = V::s_load(saveAts + u * V::width);
+        }
+    };
+
+    loadVectors();
+
+    while (live > 0) {
+        V x2[unroll], y2[unroll];
+        mask escaped[unroll], cycle[unroll];
+        unsigned done[unroll];
+        bool anyDone = false;
+
+        for (std::size_t u = 0; u < unroll; ++u) {
+            x2[u] = x[u] * x[u];
+            y2[u] = y[u] * y[u];
+
+            const V dx = x[u] - saveX[u];
+            const V dy = y[u] - saveY[u];
+
+            escaped[u] = x2[u] + y2[u] > four;
+            cycle[u] = dx * dx + dy * dy <= tolerance;
+
+            const mask finished =
+                escaped[u] | cycle[u] | (counter[u] > maxIteration);
+
+            done[u] = simd::MoveMask(finished);
+            anyDone = anyDone || done[u] != 0;
+        }
+
+        if (anyDone) {
+            for (std::size_t u = 0; u < unroll; ++u) {
+                simd::Store(xs + u * V::width, x[u]);
+                simd::Store(ys + u * V::width, y[u]);
+                simd::Store(cxs + u * V::width, cx[u]);
+                simd::Store(cys + u * V::width, cy[u]);
+                simd::Store(counters + u * V::width, counter[u]);
+                simd::Store(saveXs + u * V::width, saveX[u]);
+                simd::Store(saveYs + u * V::width, saveY[u]);
+                simd::Store(saveAts + u * V::width, saveAt[u]);
+            }
+
+            for (std::size_t u = 0; u < unroll; ++u) {
+                // an escape in the same iteration wins
+                const unsigned periodic =
+                    simd::MoveMask(cycle[u]) & ~simd::MoveMask(escaped[u]);
+
+                for (unsigned bits = done[u]; bits != 0; bits &= bits - 1) {
+                    const unsigned bit = bits & (~bits + 1);
+                    const std::size_t l = u * V::width
+                        + static_cast<std::size_t>(countTrailingZeros(bits));
+
+                    const std::uint32_t pixel = lanePixels[l];
+
+                    if ((periodic & bit) != 0) {
+                        iterations[pixel] = p.maxIteration;
+                        ++periodicPixels;
+
+                        if (p.zX != nullptr) {
+                            p.zX[pixel] =
+                                std::numeric_limits<double>::quiet_NaN();
+                        }
+                    } else {
+                        iterations[pixel] = static_cast<int>(counters[l]);
+
+                        // one that escapes right at maxIteration as well, a
+                        // resumed pixel has to find that out again
+                        if (p.zX != nullptr
+                            && iterations[pixel] == p.maxIteration) {
+                            p.zX[pixel] = static_cast<double>(xs[l]);
+                            p.zY[pixel] = static_cast<double>(ys[l]);
+                        }
+                    }
+
+                    --live;
+
+                    loadLane(l);
+                }
+            }
+
+            loadVectors();
+
+            // refilled lanes have not been checked yet
+            continue;
+        }
+
+        for (std::size_t u = 0; u < unroll; ++u) {
+            const mask save = counter[u] > saveAt[u];
+
+            saveX[u] = simd::Select(save, x[u], saveX[u]);
+            saveY[u] = simd::Select(save, y[u], saveY[u]);
+            saveAt[u] =
+                simd::Select(save, saveAt[u] + saveAt[u] + half, saveAt[u]);
+
+            counter[u] = counter[u] + one;
+
+            formula.m_apply(x[u], y[u], x2[u], y2[u], cx[u], cy[u]);
+        }
+    }
+
+    return periodicPixels;
+}
+
+// pauldelbrot's criterion, a pixel whose |z|^2 drops below this much of
+// |Z|^2 has lost the digits that tell it apart from the reference
+constexpr double glitchTolerance = 1e-6;
+
+// moves one perturbation pixel along the orbit with the longest bla steps
+// its orbit index and delta allow, rebasing on the way, until no step is
+// valid anymore, k, kEnd and n are whole numbers, T is double or floatExp
+//
+// returns false once the pixel escaped or n reached maxIteration
+template<typename T>
+bool blaAdvance(
+    const kernelParams& p,
+    const referenceOrbit& orbit,
+    const blaTable& table,
+    const T dcx,
+    const T dcy,
+    T& dx,
+    T& dy,
+    double& k,
+    double& kEnd,
+    double& n) {
+    const std::size_t levelCount = table.levels.size();
+    const double maxIteration = static_cast<double>(p.maxIteration);
+
+    for (;;) {
+        const std::size_t index = static_cast<std::size_t>(k);
+
+        const T zx = orbit.x[index] + dx;
+        const T zy = orbit.y[index] + dy;
+
+        const T r2 = zx * zx + zy * zy;
+        if (!(r2 <= T(4)) || n >= maxIteration)
+            return false;
+
+        if (p.bDetectGlitches) {
+            // the vector loop flags the pixel
+            const T z2 = orbit.x[index] * orbit.x[index]
+                + orbit.y[index] * orbit.y[index];
+
+            if (r2 < T(glitchTolerance) * z2 || k >= kEnd)
+                return true;
+        } else if (dx * dx + dy * dy > r2 || k >= kEnd) {
+            dx = zx;
+            dy = zy;
+            k = static_cast<double>(orbit.rebaseIndex);
+            kEnd = static_cast<double>(orbit.rebaseEnd);
+        }
+
+        const std::size_t from = static_cast<std::size_t>(k);
+
+        // levels only start at multiples of their length, the first one
+        // whose radius holds the delta is the longest step
+        const std::size_t alignedLevels = from == 0
+            ? levelCount
+            : std::min<std::size_t>(
+                levelCount,
+                static_cast<std::size_t>(
+                    countTrailingZeros(static_cast<unsigned>(from))));
+
+        const T d2 = dx * dx + dy * dy;
+
+        const blaStep* step = nullptr;
+        double length = 0.0;
+
+        for (std::size_t level = alignedLevels; level > 0; --level) {
+            length = static_cast<double>(std::size_t(1) << level);
+
+            if (n + length > maxIteration || k + length > kEnd)
+                continue;
+
+            const blaStep& candidate = table.levels[level - 1][from >> level];
+
+            if (d2 < candidate.r2) {
+                step = &candidate;
+                break;
+            }
+        }
+
+        if (step == nullptr && alignedLevels != 0)
+            return true;
+
+        if (step == nullptr) {
+            // one plain iteration to an even index, the levels above get
+            // their chance from there
+            const T tx = orbit.x[from] + orbit.x[from] + dx;
+            const T ty = orbit.y[from] + orbit.y[from] + dy;
+
+            const T newX = tx * dx - ty * dy + dcx;
+            const T newY = tx * dy + ty * dx + dcy;
+
+            dx = newX;
+            dy = newY;
+            k += 1.0;
+            n += 1.0;
+
+            continue;
+        }
+
+        const T newX =
+            step->ax * dx - step->ay * dy + step->bx * dcx - step->by * dcy;
+        const T newY =
+            step->ax * dy + step->ay * dx + step->bx * dcy + step->by * dcx;
+
+        dx = newX;
+        dy = newY;
+        k += length;
+        n += length;
+    }
+}
+
+// a pixel of a frame with a deltaScale iterates in floatExp until its
+// delta has this exponent, delta_c is so far below it by then that it drops
+// out of the double iterations without changing them
+constexpr double minDoubleDeltaExponent = -960.0;
+
+// runs one pixel of a frame with a deltaScale in floatExp until its delta
+// fits into a double, jumping with the bla steps of table when there is one
+//
+// returns false once the pixel escaped or n reached maxIteration
+inline bool extendedAdvance(
+    const kernelParams& p,
+    const referenceOrbit& orbit,
+    const blaTable* table,
+    const floatExp dcx,
+    const floatExp dcy,
+    floatExp& dx,
+    floatExp& dy,
+    double& k,
+    double& kEnd,
+    double& n) {
+    const double maxIteration = static_cast<double>(p.maxIteration);
+
+    // plain iterations before the bla steps get another try
+    constexpr std::size_t plainSteps = 64;
+
+    for (;;) {
+        if (table != nullptr
+            && !blaAdvance(p, orbit, *table, dcx, dcy, dx, dy, k, kEnd, n))
+            return false;
+
+        for (std::size_t i = 0; i < plainSteps; ++i) {
+            if (std::max(dx.m_log2(), dy.m_log2()) > minDoubleDeltaExponent
+                || k >= kEnd)
+                return true;
+
+            // the delta is too small to move z away from the reference
+            const std::size_t index = static_cast<std::size_t>(k);
+
+            const double zx = orbit.x[index];
+            const double zy = orbit.y[index];
+
+            if (zx * zx + zy * zy > 4.0 || n >= maxIteration)
+                return false;
+
+            const floatExp tx = zx + zx + dx;
+            const floatExp ty = zy + zy + dy;
+
+            const floatExp newX = tx * dx - ty * dy + dcx;
+            const floatExp newY = tx * dy + ty * dx + dcy;
+
+            dx = newX;
+            dy = newY;
+            k += 1.0;
+            n += 1.0;
+        }
+    }
+}
+
+// SetCurrent of fragment.glsl as perturbation, with lane refilling
+//
+// a lane iterates delta_(k + 1) = (2 Z_k + delta_k) delta_k + delta_c where
+// Z_k is the reference orbit and z = Z_k + delta_k, whenever |z| < |delta|
+// or the orbit runs out the lane rebases to delta = z on the orbit that
+// starts at zero so the delta never has to track a far away reference
+//
+// with params.bDetectGlitches lanes never rebase, pixels that meet the
+// glitch criterion or run past the end of the orbit get glitchedIteration
+//
+// with a deltaScale the pixel locations of p are below the range of double,
+// a pixel first runs in floatExp until its delta is not
+//
+// with a series a pixel starts skip iterations in with the delta the series
+// gives for it
+//
+// with a bla table a pixel first jumps as far as the table allows whenever
+// it is loaded or rebases, both happen outside of the vector loop, and only
+// iterates one step at a time where no bla step is valid
+template<typename V, std::size_t unroll>
+void perturb(
+    const kernelParams& p,
+    const perturbationState& state,
+    const std::uint32_t* pixels,
+    const std::size_t count,
+    int* iterations) {
+    using T = typename V::value_type;
+    using mask = typename V::mask;
+
+    constexpr std::size_t lanes = V::width * unroll;
+    constexpr std::uint32_t emptyLane = ~std::uint32_t(0);
+
+    const referenceOrbit& orbit = state.orbit;
+    const blaTable* table = state.bla.m_isEmpty() ? nullptr : &state.bla;
+    const seriesApproximation& series = state.series;
+
+    const T* orbitX = orbit.x.data();
+    const T* orbitY = orbit.y.data();
+
+    const T invRadius = series.m_isEmpty() ? T(0) : T(1) / series.radius;
+    const std::size_t terms = series.ax.size();
+
+    const T rebaseIndex = static_cast<T>(orbit.rebaseIndex);
+    const T rebaseEnd = static_cast<T>(orbit.rebaseEnd);
+
+    // lane state in structure of arrays layout, k is the orbit index and
+    // n the iteration count
+    alignas(64) T dxs[lanes];
+    alignas(64) T dys[lanes];
+    alignas(64) T dcxs[lanes];
+    alignas(64) T dcys[lanes];
+    alignas(64) T ks[lanes];
+    alignas(64) T kEnds[lanes];
+    alignas(64) T kSteps[lanes];
+    alignas(64) T counters[lanes];
+    // iteration count at which the lane tries its bla steps again, and
+    // how long it waited for that
+    alignas(64) T checks[lanes];
+    T checkIntervals[lanes];
+    std::uint32_t lanePixels[lanes];
+
+    std::size_t next = 0;
+    std::size_t live = 0;
+
+    // bla validity depends on |Z_k| so a lane that could not jump may be
+    // able to a bit later, it leaves the vector loop to retry after an
+    // interval that doubles every time it could not
+    const T minCheckInterval = T(128);
+    const T maxCheckInterval = T(8192);
+
+    // runs the bla steps of lane l, false when the pixel is done
+    const auto advanceLane = [&](const std::size_t l) {
+        if (table == nullptr) {
+            checks[l] = std::numeric_limits<T>::infinity();
+            return true;
+        }
+
+        const T before = counters[l];
+
+        const bool bLive = blaAdvance(
+            p,
+            orbit,
+            *table,
+            dcxs[l],
+            dcys[l],
+            dxs[l],
+            dys[l],
+            ks[l],
+            kEnds[l],
+            counters[l]);
+
+        // a plain iteration to an even orbit index does not count
+        checkIntervals[l] = counters[l] > before + T(1)
+            ? minCheckInterval
+            : std::min(checkIntervals[l] * T(2), maxCheckInterval);
+        checks[l] = counters[l] + checkIntervals[l];
+
+        return bLive;
+    };
+
+    // a parked lane sits at z = 0 of the rebase orbit and never moves
+    const auto loadLane = [&](const std::size_t l) {
+        while (next < count) {
+            const std::uint32_t pixel = pixels[next++];
+            getPixelLocation(p, pixel, dxs[l], dys[l]);
+
+            dcxs[l] = p.bUseJuliaSet ? T(0) : dxs[l];
+            dcys[l] = p.bUseJuliaSet ? T(0) : dys[l];
+            ks[l] = static_cast<T>(orbit.startIndex + series.skip);
+            kEnds[l] = static_cast<T>(orbit.startEnd);
+            kSteps[l] = T(1);
+            counters[l] = static_cast<T>(series.skip);
+
+            if (!series.m_isEmpty()) {
+                // horner on t = u / radius
+                const T tx = dxs[l] * invRadius;
+                const T ty = dys[l] * invRadius;
+
+                T sx = T(0), sy = T(0);
+
+                for (std::size_t i = terms; i-- > 0;) {
+                    const T newX = sx * tx - sy * ty + series.ax[i];
+                    sy = sx * ty + sy * tx + series.ay[i];
+                    sx = newX;
+                }
+
+                dxs[l] = sx * tx - sy * ty;
+                dys[l] = sx * ty + sy * tx;
+            }
+
+            if (p.deltaScale != 0) {
+                floatExp dx = floatExp(dxs[l]).m_ldexp(p.deltaScale);
+                floatExp dy = floatExp(dys[l]).m_ldexp(p.deltaScale);
+
+                const floatExp dcx = p.bUseJuliaSet ? floatExp() : dx;
+                const floatExp dcy = p.bUseJuliaSet ? floatExp() : dy;
+
+                if (!extendedAdvance(
+                        p,
+                        orbit,
+                        table,
+                        dcx,
+                        dcy,
+                        dx,
+                        dy,
+                        ks[l],
+                        kEnds[l],
+                        counters[l])) {
+                    iterations[pixel] = static_cast<int>(counters[l]);
+                    continue;
+                }
+
+                dxs[l] = dx.m_toDouble();
+                dys[l] = dy.m_toDouble();
+                dcxs[l] = dcx.m_toDouble();
+                dcys[l] = dcy.m_toDouble();
+            }
+
+            checkIntervals[l] = minCheckInterval / T(2);
+
+            if (advanceLane(l)) {
+                lanePixels[l] = pixel;
+                ++live;
+                return;
+            }
+
+            iterations[pixel] = static_cast<int>(counters[l]);
+        }
+
+        dxs[l] = dys[l] = dcxs[l] = dcys[l] = T(0);
+        ks[l] = rebaseIndex;
+        kEnds[l] = std::numeric_limits<T>::infinity();
+        kSteps[l] = T(0);
+        counters[l] = -std::numeric_limits<T>::infinity();
+        checks[l] = std::numeric_limits<T>::infinity();
+        lanePixels[l] = emptyLane;
+    };
+
+    for (std::size_t l = 0; l < lanes; ++l)
+        loadLane(l);
+
+    const V zero = V::s_broadcast(T(0));
+    const V one = V::s_broadcast(T(1));
+    const V four = V::s_broadcast(T(4));
+    const V maxIteration =
+        V::s_broadcast(static_cast<T>(p.maxIteration) - T(0.5));
+    const V rebaseStart = V::s_broadcast(rebaseIndex);
+    const V rebaseLast = V::s_broadcast(rebaseEnd);
+    const V tolerance = V::s_broadcast(T(glitchTolerance));
+
+    V dx[unroll], dy[unroll], dcx[unroll], dcy[unroll];
+    V k[unroll], kEnd[unroll], kStep[unroll], counter[unroll], check[unroll];
+
+    const auto loadVectors = [&]() {
+        for (std::size_t u = 0; u < unroll; ++u) {
+            const std::size_t offset = u * V::width;
+
+            dx[u] = V::s_load(dxs + offset);
+            dy[u] = V::s_load(dys + offset);
+            dcx[u] = V::s_load(dcxs + offset);
+            dcy[u] = V::s_load(dcys + offset);
+            k[u] = V::s_load(ks + offset);
+            kEnd[u] = V::s_load(kEnds + offset);
+            kStep[u] = V::s_load(kSteps + offset);
+            counter[u] = V::s_load(counters + offset);
+            check[u] = V::s_load(checks + offset);
+        }
+    };
+
+    loadVectors();
+
+    while (live > 0) {
+        V refX[unroll], refY[unroll], zx[unroll], zy[unroll], r2[unroll];
+        unsigned done[unroll], glitched[unroll];
+        bool anyDone = false;
+
+        for (std::size_t u = 0; u < unroll; ++u) {
+            refX[u] = simd::Gather(orbitX, k[u]);
+            refY[u] = simd::Gather(orbitY, k[u]);
+
+            zx[u] = refX[u] + dx[u];
+            zy[u] = refY[u] + dy[u];
+            r2[u] = zx[u] * zx[u] + zy[u] * zy[u];
+
+            const mask finished =
+                (r2[u] > four) | (counter[u] > maxIteration);
+            done[u] = simd::MoveMask(finished);
+            glitched[u] = 0;
+
+            // lanes leave the vector loop for their bla steps now and then
+            if (table != nullptr)
+                done[u] |= simd::MoveMask(counter[u] > check[u]);
+
+            if (p.bDetectGlitches) {
+                const V ref2 = refX[u] * refX[u] + refY[u] * refY[u];
+                const mask glitch = (tolerance * ref2 > r2[u])
+                    | (k[u] + V::s_broadcast(T(0.5)) > kEnd[u]);
+
+                glitched[u] =
+                    simd::MoveMask(glitch) & ~simd::MoveMask(finished);
+                done[u] |= glitched[u];
+            }
+
+            anyDone = anyDone || done[u] != 0;
+        }
+
+        if (anyDone) {
+            for (std::size_t u = 0; u < unroll; ++u) {
+                const std::size_t offset = u * V::width;
+
+                simd::Store(dxs + offset, dx[u]);
+                simd::Store(dys + offset, dy[u]);
+                simd::Store(dcxs + offset, dcx[u]);
+                simd::Store(dcys + offset, dcy[u]);
+                simd::Store(ks + offset, k[u]);
+                simd::Store(kEnds + offset, kEnd[u]);
+                simd::Store(kSteps + offset, kStep[u]);
+                simd::Store(counters + offset, counter[u]);
+                simd::Store(checks + offset, check[u]);
+            }
+
+            for (std::size_t u = 0; u < unroll; ++u) {
+                for (unsigned bits = done[u]; bits != 0; bits &= bits - 1) {
+                    const unsigned bit = bits & (~bits + 1);
+                    const std::size_t l = u * V::width
+                        + static_cast<std::size_t>(countTrailingZeros(bits));
+
+                    if ((glitched[u] & bit) != 0) {
+                        iterations[lanePixels[l]] = glitchedIteration;
+                    } else {
+                        // a retrying lane that is not done keeps its pixel
+                        if (table != nullptr && advanceLane(l))
+                            continue;
+
+                        iterations[lanePixels[l]] =
+                            static_cast<int>(counters[l]);
+                    }
+
+                    --live;
+
+                    loadLane(l);
+                }
+            }
+
+            loadVectors();
+
+            continue;
+        }
+
+        for (std::size_t u = 0; u < unroll; ++u) {
+            const mask rebase = (dx[u] * dx[u] + dy[u] * dy[u] > r2[u])
+                | (k[u] + V::s_broadcast(T(0.5)) > kEnd[u]);
+
+            if (!p.bDetectGlitches && simd::Any(rebase)) {
+                dx[u] = simd::Select(rebase, zx[u], dx[u]);
+                dy[u] = simd::Select(rebase, zy[u], dy[u]);
+                refX[u] = simd::Select(rebase, zero, refX[u]);
+                refY[u] = simd::Select(rebase, zero, refY[u]);
+                k[u] = simd::Select(rebase, rebaseStart, k[u]);
+                kEnd[u] = simd::Select(rebase, rebaseLast, kEnd[u]);
+            }
+
+            const V tx = refX[u] + refX[u] + dx[u];
+            const V ty = refY[u] + refY[u] + dy[u];
+
+            const V newX = simd::FMAdd(tx, dx[u], dcx[u]) - ty * dy[u];
+            const V newY =
+                simd::FMAdd(tx, dy[u], simd::FMAdd(ty, dx[u], dcy[u]));
+
+            dx[u] = newX;
+            dy[u] = newY;
+
+            k[u] = k[u] + kStep[u];
+            counter[u] = counter[u] + one;
+        }
+    }
+}
+
+// escapeRefill with z and c in double-double, for zooms past what a double
+// resolves that are still cheaper than a reference orbit
+template<typename V, std::size_t unroll, fractalMode fractal>
+std::size_t escapeDoubleDouble(
+    const kernelParams& p,
+    const std::uint32_t* pixels,
+    const std::size_t count,
+    int* iterations) {
+    using mask = typename V::mask;
+    using number = dd::doubleDouble<V>;
+    using scalarNumber = dd::doubleDouble<simd::scalarVec<double>>;
+
+    constexpr std::size_t lanes = V::width * unroll;
+    constexpr std::uint32_t emptyLane = ~std::uint32_t(0);
+
+    // lane state in structure of arrays layout, hi and lo parts apart
+    alignas(64) double xs[2][lanes];
+    alignas(64) double ys[2][lanes];
+    alignas(64) double cxs[2][lanes];
+    alignas(64) double cys[2][lanes];
+    alignas(64) double counters[lanes];
+    alignas(64) double saveXs[2][lanes];
+    alignas(64) double saveYs[2][lanes];
+    alignas(64) double saveAts[lanes];
+    std::uint32_t lanePixels[lanes];
+
+    std::size_t next = 0;
+    std::size_t live = 0;
+    std::size_t periodicPixels = 0;
+
+    const scalarNumber infinity {
+        {std::numeric_limits<double>::infinity()},
+        {0.0}};
+
+    const auto setLane = [](double (&values)[2][lanes],
+                            const std::size_t l,
+                            const scalarNumber v) {
+        values[0][l] = v.hi.v;
+        values[1][l] = v.lo.v;
+    };
+
+    const auto loadLane = [&](const std::size_t l) {
+        while (next < count) {
+            const std::uint32_t pixel = pixels[next++];
+
+            scalarNumber x, y;
+            getPixelLocation(p, pixel, x, y);
+
+            // the high parts decide it, a pixel within their rounding of
+            // the boundary would take far more than maxIteration to escape
+            if constexpr (fractal == fractalMode::mandelbrot) {
+                if (!isOutsideMainBulbs(x.hi, y.hi)) {
+                    iterations[pixel] = p.maxIteration;
+                    continue;
+                }
+            }
+
+            setLane(xs, l, x);
+            setLane(ys, l, y);
+
+            if constexpr (fractal == fractalMode::julia) {
+                setLane(cxs, l, {{p.juliaX}, {0.0}});
+                setLane(cys, l, {{p.juliaY}, {0.0}});
+            } else {
+                setLane(cxs, l, x);
+                setLane(cys, l, y);
+            }
+            counters[l] = 0.0;
+            setLane(saveXs, l, infinity);
+            setLane(saveYs, l, infinity);
+            saveAts[l] = 0.5;
+            lanePixels[l] = pixel;
+            ++live;
+
+            return;
+        }
+
+        const scalarNumber zero {{0.0}, {0.0}};
+
+        setLane(xs, l, zero);
+        setLane(ys, l, zero);
+        setLane(cxs, l, zero);
+        setLane(cys, l, zero);
+        counters[l] = -std::numeric_limits<double>::infinity();
+        setLane(saveXs, l, infinity);
+        setLane(saveYs, l, infinity);
+        saveAts[l] = 0.5;
+        lanePixels[l] = emptyLane;
+    };
+
+    for (std::size_t l = 0; l < lanes; ++l)
+        loadLane(l);
+
+    const V half = V::s_broadcast(0.5);
+    const V one = V::s_broadcast(1.0);
+    const V four = V::s_broadcast(4.0);
+    const V maxIteration =
+        V::s_broadcast(static_cast<double>(p.maxIteration) - 0.5);
+    const V tolerance =
+        V::s_broadcast(p.periodicityTolerance * p.periodicityTolerance);
+
+    number x[unroll], y[unroll], cx[unroll], cy[unroll];
+    number saveX[unroll], saveY[unroll];
+    V counter[unroll], saveAt[unroll];
+
+    const auto loadNumber = [](const double (&values)[2][lanes],
+                               const std::size_t offset) {
+        return number {
+            V::s_load(values[0] + offset),
+            V::s_load(values[1] + offset)};
+    };
+    const auto storeNumber = [](double (&values)[2][lanes],
+                                const std::size_t offset,
+                                const number v) {
+        simd::Store(values[0] + offset, v.hi);
+        simd::Store(values[1] + offset, v.lo);
+    };
+
+    const auto loadVectors = [&]() {
+        for (std::size_t u = 0; u < unroll; ++u) {
+            const std::size_t offset = u * V::width;
+
+            x[u] = loadNumber(xs, offset);
+            y[u] = loadNumber(ys, offset);
+            cx[u] = loadNumber(cxs, offset);
+            cy[u] = loadNumber(cys, offset);
+            counter[u] = V::s_load(counters + offset);
+            saveX[u] = loadNumber(saveXs, offset);
+            saveY[u] = loadNumber(saveYs, offset);
+            saveAt[u] = V::s_load(saveAts + offset);
+        }
+    };
+
+    loadVectors();
+
+    while (live > 0) {
+        number x2[unroll], y2[unroll];
+        mask escaped[unroll], cycle[unroll];
+        unsigned done[unroll];
+        bool anyDone = false;
+
+        for (std::size_t u = 0; u < unroll; ++u) {
+            x2[u] = dd::Square(x[u]);
+            y2[u] = dd::Square(y[u]);
+
+            // the high parts of a z next to the saved one cancel exactly
+            const V dx = (x[u].hi - saveX[u].hi) + (x[u].lo - saveX[u].lo);
+            const V dy = (y[u].hi - saveY[u].hi) + (y[u].lo - saveY[u].lo);
+
+            // the low parts can not move the sum across 4 by more than an
+            // ulp, not worth the additions
+            escaped[u] = x2[u].hi + y2[u].hi > four;
+            cycle[u] = dx * dx + dy * dy <= tolerance;
+
+            const mask finished =
+                escaped[u] | cycle[u] | (counter[u] > maxIteration);
+
+            done[u] = simd::MoveMask(finished);
+            anyDone = anyDone || done[u] != 0;
+        }
+
+        if (anyDone) {
+            for (std::size_t u = 0; u < unroll; ++u) {
+                const std::size_t offset = u * V::width;
+
+                storeNumber(xs, offset, x[u]);
+                storeNumber(ys, offset, y[u]);
+                storeNumber(cxs, offset, cx[u]);
+                storeNumber(cys, offset, cy[u]);
+                simd::Store(counters + offset, counter[u]);
+                storeNumber(saveXs, offset, saveX[u]);
+                storeNumber(saveYs, offset, saveY[u]);
+                simd::Store(saveAts + offset, saveAt[u]);
+            }
+
+            for (std::size_t u = 0; u < unroll; ++u) {
+                const unsigned periodic =
+                    simd::MoveMask(cycle[u]) & ~simd::MoveMask(escaped[u]);
+
+                for (unsigned bits = done[u]; bits != 0; bits &= bits - 1) {
+                    const unsigned bit = bits & (~bits + 1);
+                    const std::size_t l = u * V::width
+                        + static_cast<std::size_t>(countTrailingZeros(bits));
+
+                    if ((periodic & bit) != 0) {
+                        iterations[lanePixels[l]] = p.maxIteration;
+                        ++periodicPixels;
+                    } else {
+                        iterations[lanePixels[l]] =
+                            static_cast<int>(counters[l]);
+                    }
+
+                    --live;
+
+                    loadLane(l);
+                }
+            }
+
+            loadVectors();
+
+            continue;
+        }
+
+        for (std::size_t u = 0; u < unroll; ++u) {
+            const mask save = counter[u] > saveAt[u];
+
+            saveX[u] = {
+                simd::Select(save, x[u].hi, saveX[u].hi),
+                simd::Select(save, x[u].lo, saveX[u].lo)};
+            saveY[u] = {
+                simd::Select(save, y[u].hi, saveY[u].hi),
+                simd::Select(save, y[u].lo, saveY[u].lo)};
+            saveAt[u] =
+                simd::Select(save, saveAt[u] + saveAt[u] + half, saveAt[u]);
+
+            counter[u] = counter[u] + one;
+
+            y[u] = dd::Twice(x[u] * y[u]) + cy[u];
+            x[u] = x2[u] - y2[u] + cx[u];
+        }
+    }
+
+    return periodicPixels;
+}
+
+template<
+    typename V,
+    std::size_t unroll,
+    laneMode mode,
+    fractalMode fractal,
+    typename step>
+std::size_t escapeLanes(
+    const kernelParams& p,
+    const std::uint32_t* pixels,
+    const std::size_t count,
+    int* iterations) {
+    if constexpr (mode == laneMode::refill)
+        return escapeRefill<V, unroll, fractal, step>(
+            p,
+            pixels,
+            count,
+            iterations);
+    else
+        return escapeGroups<V, unroll, fractal, step>(
+            p,
+            pixels,
+            count,
+            iterations);
+}
+
+// the kernels of every exponent class of one lane mode, fractal mode and
+// precision, n runs over the exponent classes of the whole exponents
+template<
+    typename V,
+    std::size_t unroll,
+    laneMode mode,
+    fractalMode fractal,
+    std::size_t... n>
+void setExponentKernels(
+    escapeFunc (&kernels)[exponentClassCount],
+    std::index_sequence<n...>) {
+    ((kernels[n] = &escapeLanes<
+          V,
+          unroll,
+          mode,
+          fractal,
+          integerStep<static_cast<int>(n) + minIntegerExponent>>),
+     ...);
+
+    kernels[polarExponentClass] =
+        &escapeLanes<V, unroll, mode, fractal, polarStep>;
+}
+
+// every kernel of one lane mode and fractal mode
+template<std::size_t unroll, laneMode mode, fractalMode fractal>
+void setFractalKernels(kernelTable& table) {
+    using integerClasses = std::make_index_sequence<polarExponentClass>;
+    using exponentKernels = escapeFunc[exponentClassCount];
+
+    const auto get = [&](const precision p) -> exponentKernels& {
+        return table.escape[static_cast<std::size_t>(mode)]
+                           [static_cast<std::size_t>(p)]
+                           [static_cast<std::size_t>(fractal)];
+    };
+
+    setExponentKernels<simd::floatVec, 1, mode, fractal>(
+        get(precision::singleFloat),
+        integerClasses());
+    setExponentKernels<simd::doubleVec, unroll, mode, fractal>(
+        get(precision::doubleFloat),
+        integerClasses());
+
+    // double-double lanes are always refilled and other exponents run in
+    // double
+    exponentKernels& extended = get(precision::doubleDouble);
+
+    setExponentKernels<simd::doubleVec, unroll, laneMode::refill, fractal>(
+        extended,
+        integerClasses());
+
+    extended[static_cast<std::size_t>(2 - minIntegerExponent)] =
+        &escapeDoubleDouble<simd::doubleVec, unroll, fractal>;
+}
+
+template<std::size_t unroll, laneMode mode>
+void setLaneKernels(kernelTable& table) {
+    setFractalKernels<unroll, mode, fractalMode::mandelbrot>(table);
+    setFractalKernels<unroll, mode, fractalMode::julia>(table);
+}
+
+inline kernelTable MakeKernelTable(const isa set, const char* name) {
+    // two double vectors per group so avx2 runs 8 and avx512 16 pixels at
+    // once in both precisions
+    constexpr std::size_t doubleUnroll = simd::doubleVec::width > 1 ? 2 : 1;
+
+    kernelTable table {};
+
+    table.set = set;
+    table.name = name;
+
+    setLaneKernels<doubleUnroll, laneMode::grouped>(table);
+    setLaneKernels<doubleUnroll, laneMode::refill>(table);
+
+    table.perturb = &perturb<simd::doubleVec, doubleUnroll>;
+
+    return table;
+}
+
+}  // namespace mandel::core::MANDEL_KERNEL_ISA
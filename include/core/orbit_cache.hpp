@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "core/big_float.hpp"
+#include "core/reference_orbit.hpp"
+#include "core/view.hpp"
+
+namespace mandel::core {
+
+// reference orbits kept as files of a directory so later frames and later
+// runs skip the arbitrary precision iteration, a file holds the most
+// precise orbit computed so far for one center, maxIteration and julia
+// constant and is memory mapped to be read
+//
+// files are replaced whole by a rename, concurrent readers and writers of
+// the same directory only ever see complete ones, a read marks a file as
+// used and the least recently used files are removed once the directory
+// is past its byte budget
+
+// reads the orbit of center for v from directory when its file is there
+// and precise enough
+bool LoadReferenceOrbit(
+    const std::string& directory,
+    const view& v,
+    const bigVec2& center,
+    referenceOrbit& orbit);
+
+// writes orbit to directory, creating it first, unless the file there is
+// at least as precise or orbit alone is past budget, then removes the least
+// recently used files until the directory holds at most budget bytes
+void StoreReferenceOrbit(
+    const std::string& directory,
+    const std::size_t budget,
+    const referenceOrbit& orbit);
+
+// the orbit of center for v, orbit is kept when IsReferenceOrbitOf, then
+// directory is tried and last it is computed, an empty directory turns the
+// files off
+//
+// a computed orbit is stored to directory with StoreReferenceOrbit on a
+// thread of its own so the frame does not wait for the file, orbits that
+// come while a few are still waiting to be written are not stored
+orbitSource GetReferenceOrbit(
+    const view& v,
+    const bigVec2& center,
+    const std::string& directory,
+    const std::size_t budget,
+    referenceOrbit& orbit);
+
+}  // namespace mandel::core
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "core/bla.hpp"
+#include "core/reference_orbit.hpp"
+#include "core/series.hpp"
+
+namespace mandel::core {
+
+// what a perturbation frame computes once before its pixels, kept between
+// frames to reuse the allocations
+//
+// an empty bla table or series is simply not used
+struct perturbationState {
+    referenceOrbit orbit;
+    orbitSource source = orbitSource::computed;
+    blaTable bla;
+    seriesApproximation series;
+};
+
+}  // namespace mandel::core
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "core/big_float.hpp"
+#include "core/view.hpp"
+#include "vec4.hpp"
+
+namespace mandel::core {
+
+// orbit of one point iterated in arbitrary precision, every pixel of a
+// perturbation frame only iterates its small double delta from it
+//
+// a lane moves to the rebase orbit, which starts at z = 0, as soon as its z
+// gets smaller than its delta or it reaches the end of the orbit it is on,
+// for the mandelbrot set both are the same orbit, for julia sets the orbit
+// of the critical point is stored after the one of the reference
+struct referenceOrbit {
+    // z of the orbit at every iteration, rounded to double
+    std::vector<double> x, y;
+
+    // index and last index of the orbit a pixel starts on
+    std::size_t startIndex = 0;
+    std::size_t startEnd = 0;
+
+    // index and last index of the rebase orbit, x[rebaseIndex] is zero
+    std::size_t rebaseIndex = 0;
+    std::size_t rebaseEnd = 0;
+
+    // the point the orbit belongs to and the parts of the view it was
+    // computed for, precision is in bits
+    bigVec2 center;
+    std::size_t precision = 0;
+    int maxIteration = 0;
+    bool bUseJuliaSet = false;
+    vec4<double> juliaConstant {0.0, 0.0};
+};
+
+// how the orbit of a perturbation frame came about
+enum class orbitSource {
+    computed,
+    // the orbit of the previous frame was still valid
+    reused,
+    // read from the orbit cache directory
+    loaded
+};
+
+// bits the reference needs so its error stays far below one pixel
+std::size_t GetReferencePrecision(const view& v);
+
+// whether orbit is what ComputeReferenceOrbit gives for v and center, one
+// of more precision than v needs is just as good
+bool IsReferenceOrbitOf(
+    const view& v,
+    const bigVec2& center,
+    const referenceOrbit& orbit);
+
+// iterate center with the formula and maxIteration of v
+void ComputeReferenceOrbit(
+    const view& v,
+    const bigVec2& center,
+    referenceOrbit& orbit);
+
+}  // namespace mandel::core
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "core/kernel.hpp"
+#include "core/view.hpp"
+
+namespace mandel::core {
+
+class threadPool;
+
+// how the pixels of a tile are computed
+enum class fillMode {
+    // the kernel runs for every pixel like fragment.glsl
+    everyPixel,
+    // mariani-silver, a rectangle whose border has one iteration count is
+    // filled with it and every other one is split in two, a set or band
+    // that only reaches inside through the border is never missed but an
+    // island that does not touch it is
+    subdivide,
+    // only the pixels next to a change of iteration count are computed,
+    // starting from the border, the regions of one escaped count they
+    // enclose are filled and the ones inside the set once the pixels
+    // around them are caught in a cycle, an island of another count inside
+    // a band or such a ring that touches no computed pixel is missed,
+    // tests/fill.cpp checks a few views against every pixel
+    boundaryTrace
+};
+
+struct renderOptions {
+    precision floatType = precision::doubleFloat;
+    // floatType is ignored and every frame runs with SelectPrecision
+    bool bAutoPrecision = false;
+    // perturbation frames skip iterations with a bla table
+    bool bUseBla = true;
+    // and start every pixel at the iteration a series approximation of
+    // this many terms reaches, 0 turns it off
+    int seriesTerms = 0;
+    // perturbation pixels do not rebase, glitched ones are detected and
+    // rendered again with references of their own
+    bool bDetectGlitches = false;
+    // directory the reference orbits of the screen center are cached in
+    // across frames and runs, see orbit_cache.hpp, empty turns it off
+    std::string orbitCacheDirectory;
+    // bytes the files of orbitCacheDirectory may take
+    std::size_t orbitCacheBudget = std::size_t {256} << 20;
+    laneMode lanes = laneMode::refill;
+
+    fillMode fill = fillMode::everyPixel;
+
+    // used by renderer, 0 threads means one per hardware thread
+    int threadCount = 0;
+    // width and height of the square tiles a frame is split into
+    int tileSize = 64;
+    // frames with another fill than fillMode::everyPixel are rendered a
+    // second time pixel by pixel and the differences counted
+    bool bVerifyFill = false;
+    // bytes of iterations renderer keeps as tiles of the complex plane to
+    // reuse in later frames, which take their pixels from the nearest
+    // samples of the tiles, see tile_cache.hpp, 0 turns it off
+    std::size_t tileCacheBudget = 0;
+};
+
+// the precision a frame runs with and a short human readable reason
+struct precisionChoice {
+    precision floatType = precision::doubleFloat;
+    const char* reason = "";
+};
+
+// cheapest precision that still resolves the pixel spacing of the view
+// with a few guard bits for the rounding errors of maxIteration iterations,
+// precision::singleFloat is what fragment.glsl can draw
+//
+// float, double and double-double cover spacings down to about 1e-4, 1e-12
+// and 1e-28 of the coordinate magnitude, deeper frames use perturbation,
+// other exponents than 2 stop at double
+precisionChoice SelectPrecision(
+    const view& v,
+    const int width,
+    const int height);
+
+// the kernel and per frame data every pixel of a frame runs with
+struct frameKernel {
+    kernelParams params;
+
+    // what the kernel was picked for
+    precisionChoice choice;
+
+    escapeFunc escape = nullptr;
+
+    // escape is a refill kernel of float or double, which keep and resume
+    // z with kernelParams::zX
+    bool bResumable = false;
+
+    // set instead of escape for perturbation frames
+    perturbFunc perturb = nullptr;
+    const perturbationState* state = nullptr;
+
+    // returns the pixels periodicity detection stopped early, perturbation
+    // kernels do not look for cycles
+    std::size_t m_run(
+        const std::uint32_t* pixels,
+        const std::size_t count,
+        int* iterations) const {
+        if (perturb == nullptr)
+            return escape(params, pixels, count, iterations);
+
+        perturb(params, *state, pixels, count, iterations);
+        return 0;
+    }
+};
+
+// picks the kernel for options, perturbation frames compute their reference
+// orbit, bla table and series into state, which has to outlive the returned
+// frameKernel, the orbit already in state is kept when it is still valid
+//
+// perturbation and double-double only cover exponent 2, other exponents run
+// in double
+frameKernel GetFrameKernel(
+    const view& v,
+    const int width,
+    const int height,
+    const renderOptions& options,
+    perturbationState& state);
+
+struct glitchStats {
+    // pixels the first pass left glitched
+    std::size_t glitchedPixels = 0;
+    // secondary reference orbits computed for them
+    std::size_t references = 0;
+};
+
+// renders the pixels kernel left at glitchedIteration again, for a few
+// rounds the largest glitch regions get a reference of their own and what
+// is still glitched after that is rendered with rebasing
+//
+// the regions of a round run on pool when there is one
+glitchStats CorrectGlitches(
+    const view& v,
+    const int width,
+    const int height,
+    const renderOptions& options,
+    const frameKernel& kernel,
+    int* iterations,
+    threadPool* pool = nullptr);
+
+// compute the escape iteration of every pixel of a width x height frame on
+// the calling thread, iterations is row major and has to hold
+// width * height values
+void RenderIterations(
+    const view& v,
+    const int width,
+    const int height,
+    int* iterations,
+    const renderOptions& options = {});
+
+// SetColor of fragment.glsl, writes count rgba8 pixels into rgba
+void ColorIterations(
+    const palette& p,
+    const int maxIteration,
+    const int* iterations,
+    const std::size_t count,
+    std::uint8_t* rgba);
+
+// RenderIterations followed by ColorIterations
+// rgba has to hold width * height * 4 bytes
+void Render(
+    const view& v,
+    const palette& p,
+    const int width,
+    const int height,
+    std::uint8_t* rgba);
+
+}  // namespace mandel::core
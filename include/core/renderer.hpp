@@ -0,0 +1,209 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/fill.hpp"
+#include "core/render.hpp"
+#include "core/thread_pool.hpp"
+#include "core/tile_cache.hpp"
+
+namespace mandel::core {
+
+struct frameStats {
+    // wall time of the last m_render in milliseconds
+    double renderTime = 0.0;
+
+    std::size_t tileCount = 0;
+    std::size_t threadCount = 0;
+    // tiles that ran on another thread than they were queued on
+    std::size_t stolenTiles = 0;
+
+    const char* kernelName = "";
+
+    // precision tier the frame ran with, and why
+    precisionChoice tier;
+
+    // perturbation frames, time spent on the reference orbit and its tables
+    // in milliseconds, where the orbit came from, its length, the bla levels
+    // and the iterations the series skips
+    double referenceTime = 0.0;
+    orbitSource referenceSource = orbitSource::computed;
+    std::size_t referenceLength = 0;
+    std::size_t blaLevels = 0;
+    std::size_t seriesSkip = 0;
+
+    // glitch detection of perturbation frames
+    glitchStats glitches;
+
+    // pixels periodicity detection gave maxIteration early and their share
+    // of the frame
+    std::size_t periodicPixels = 0;
+    double periodicFraction = 0.0;
+
+    // pixels the kernel ran for, the fill modes skip the others
+    std::size_t computedPixels = 0;
+    // with renderOptions::bVerifyFill, pixels the fill got wrong
+    std::size_t fillMismatches = 0;
+
+    // the last m_update kept the frame it already had, the other stats are
+    // those of the frame when it was rendered
+    bool bKept = false;
+    // pixels m_update continued from the z a lower maxIteration left them at
+    std::size_t resumedPixels = 0;
+    // whole pixels the last m_update moved the kept frame by, only the
+    // strips it uncovered were rendered
+    int panX = 0;
+    int panY = 0;
+
+    // of renderOptions::tileCacheBudget, tiles of m_update frames that
+    // came from earlier ones
+    tileCacheStats cache;
+};
+
+// multi threaded RenderIterations, a frame is split into tiles that run on
+// a work stealing pool
+class renderer {
+  public:
+    explicit renderer(const renderOptions& options = {});
+
+    [[nodiscard]] const renderOptions& options() const noexcept {
+        return m_options;
+    }
+
+    // resizes the pool when the thread count changes
+    void setOptions(const renderOptions& options);
+
+    [[nodiscard]] const frameStats& stats() const noexcept {
+        return m_stats;
+    }
+
+    // iterations is row major and has to hold width * height values, so do
+    // zX and zY when they are set, they get the z of kernelParams::zX and
+    // nan in zX for the pixels taken for inside without one, returns
+    // whether the kernel wrote them
+    bool m_render(
+        const view& v,
+        const int width,
+        const int height,
+        int* iterations,
+        double* zX = nullptr,
+        double* zY = nullptr);
+
+    // m_render into the frame the renderer keeps, unless it already holds
+    // v at width x height rendered with the same options, so a palette
+    // change only colors it again, returns whether it rendered
+    //
+    // when only maxIteration went up the pixels that escaped keep their
+    // count, the others continue from their z when the kernel kept it and
+    // start over when not, when only the center moved by whole pixels of
+    // the lattice of GetKernelParams the frame is moved along and the
+    // strips it uncovers are rendered, either gives the frame rendered
+    // anew, neither happens with fillMode::subdivide, whose fill depends on
+    // the rects it is split into, or renderOptions::bVerifyFill, which
+    // checks whole frames, and perturbation frames are not moved as their
+    // pixels depend on the reference and tables of the frame
+    //
+    // with renderOptions::tileCacheBudget every other frame is taken from
+    // the samples of the tile cache, moved ones and the ones after a frame
+    // of the cache too
+    bool m_update(const view& v, const int width, const int height);
+
+    // the frame of the last m_update, row major
+    [[nodiscard]] const std::vector<int>& frame() const noexcept {
+        return m_frame;
+    }
+
+  private:
+    // m_render into m_frame from the samples of m_tileCache, the tiles it
+    // does not have are computed on the pool and kept
+    void m_renderCached(const view& v, const int width, const int height);
+
+    // m_update of a view that only raised the maxIteration of the frame,
+    // returns false when the frame has to be rendered anew
+    bool m_resume(const view& v, const int width, const int height);
+
+    // m_update of a view that only moved the center of the frame by whole
+    // pixels, the pixel (x, y) of v is (x + offsetX, y + offsetY) of the
+    // frame, returns false when the frame has to be rendered anew, which it
+    // also is when its pixels are not on the lattice of v
+    bool m_pan(
+        const view& v,
+        const int width,
+        const int height,
+        const int offsetX,
+        const int offsetY);
+
+    using timePoint = std::chrono::steady_clock::time_point;
+
+    // the stats of a frame of pixelCount pixels that started at startTime
+    // and had its kernel at orbitTime
+    void m_setFrameStats(
+        const frameKernel& kernel,
+        const fillStats& filled,
+        const std::size_t tileCount,
+        const std::size_t pixelCount,
+        const timePoint startTime,
+        const timePoint orbitTime);
+
+    // runs the tiles of area of a frame of width on the pool
+    fillStats m_fillTiles(
+        const frameKernel& kernel,
+        const fillMode mode,
+        const int width,
+        const pixelRect& area,
+        int* iterations);
+
+    renderOptions m_options;
+    threadPool m_pool;
+
+    // reused between perturbation frames, so is its orbit while the center
+    // stays the same
+    perturbationState m_perturbation;
+
+    // pixel index list of the tile each worker is running
+    std::vector<std::vector<std::uint32_t>> m_tilePixels;
+    std::size_t m_tileCount = 0;
+
+    // the pixel by pixel frame of bVerifyFill
+    std::vector<int> m_verifyIterations;
+
+    // z of m_render frames whose caller keeps none, fillMode::boundaryTrace
+    // reads the pixels caught in a cycle from it
+    std::vector<double> m_traceZX;
+    std::vector<double> m_traceZY;
+
+    // m_update's frame and what it holds, m_bFrameValid is reset by
+    // options that change the iterations
+    std::vector<int> m_frame;
+    view m_frameView;
+    int m_frameWidth = 0;
+    int m_frameHeight = 0;
+    precision m_framePrecision = precision::doubleFloat;
+    bool m_bFrameValid = false;
+
+    // z of the frame pixels when m_bFrameZ, see kernelParams::zX
+    std::vector<double> m_frameZX;
+    std::vector<double> m_frameZY;
+    bool m_bFrameZ = false;
+    // the frame was taken from m_tileCache
+    bool m_bFrameCached = false;
+
+    // the pixels m_resume continues from their z and the ones it starts
+    // over
+    std::vector<std::uint32_t> m_resumePixels;
+    std::vector<std::uint32_t> m_restartPixels;
+
+    // iterations of earlier m_update frames, the tiles m_renderCached takes
+    // with their samples and the indices of the ones it computes
+    tileCache m_tileCache;
+    std::vector<tileCache::tileData> m_cacheTiles;
+    std::vector<const int*> m_cacheSamples;
+    std::vector<std::size_t> m_missingTiles;
+
+    frameStats m_stats;
+};
+
+}  // namespace mandel::core
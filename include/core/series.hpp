@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "core/reference_orbit.hpp"
+
+namespace mandel::core {
+
+// truncated power series of the perturbation delta in u, the offset of a
+// pixel from the reference, u is delta_c for the mandelbrot set and the
+// start delta for julia sets
+//
+// delta at orbit index startIndex + skip is the sum of coefficient i times
+// (u / radius)^(i + 1), the division keeps the high powers inside the
+// range of double
+struct seriesApproximation {
+    std::vector<double> ax, ay;
+    double radius = 0.0;
+
+    // iterations every pixel of the frame starts with
+    std::size_t skip = 0;
+
+    [[nodiscard]] bool m_isEmpty() const noexcept {
+        return skip == 0;
+    }
+};
+
+// iterates a series of terms coefficients along orbit for as long as it
+// stays within a relative 2^-32 of the probe deltas, which run through plain
+// perturbation next to it, the probes should be the farthest pixels from
+// the reference, the frame corners and edge centers
+//
+// the series also stops where a probe would escape or rebase
+void ComputeSeriesApproximation(
+    const referenceOrbit& orbit,
+    const bool bUseJuliaSet,
+    const double* probeX,
+    const double* probeY,
+    const std::size_t probeCount,
+    const std::size_t terms,
+    seriesApproximation& series);
+
+}  // namespace mandel::core
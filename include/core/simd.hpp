@@ -0,0 +1,621 @@
+#pragma once
+
+// thin wrappers around the vector registers the kernels are written against
+//
+// every kernel translation unit defines MANDEL_KERNEL_ISA before including
+// this file, the types live in a namespace named after it so the inline
+// functions of a unit compiled with -mavx512f never get merged into a unit
+// that has to run on an avx2 or sse2 only cpu
+
+#ifndef MANDEL_KERNEL_ISA
+    #error "simd.hpp can only be included by a kernel translation unit"
+#endif
+
+#include <cmath>
+#include <cstddef>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+    #include <immintrin.h>
+#endif
+
+namespace mandel::core::MANDEL_KERNEL_ISA::simd {
+
+// one lane, used for the fallback kernels and the tails of the vector ones
+template<typename T>
+struct scalarVec {
+    using value_type = T;
+    using mask = bool;
+
+    static constexpr std::size_t width = 1;
+
+    T v;
+
+    static scalarVec s_broadcast(const T x) {
+        return {x};
+    }
+    static scalarVec s_load(const T* p) {
+        return {*p};
+    }
+};
+
+template<typename T>
+inline void Store(T* p, const scalarVec<T> a) {
+    *p = a.v;
+}
+
+template<typename T>
+inline scalarVec<T> operator+(const scalarVec<T> a, const scalarVec<T> b) {
+    return {a.v + b.v};
+}
+template<typename T>
+inline scalarVec<T> operator-(const scalarVec<T> a, const scalarVec<T> b) {
+    return {a.v - b.v};
+}
+template<typename T>
+inline scalarVec<T> operator*(const scalarVec<T> a, const scalarVec<T> b) {
+    return {a.v * b.v};
+}
+template<typename T>
+inline scalarVec<T> operator/(const scalarVec<T> a, const scalarVec<T> b) {
+    return {a.v / b.v};
+}
+template<typename T>
+inline bool operator<=(const scalarVec<T> a, const scalarVec<T> b) {
+    return a.v <= b.v;
+}
+// true for nan, the negation of <=
+template<typename T>
+inline bool operator>(const scalarVec<T> a, const scalarVec<T> b) {
+    return !(a.v <= b.v);
+}
+
+// a * b + c
+template<typename T>
+inline scalarVec<T>
+FMAdd(const scalarVec<T> a, const scalarVec<T> b, const scalarVec<T> c) {
+    return {a.v * b.v + c.v};
+}
+
+// a * b - c rounded once, exact enough for the error free products of the
+// double-double kernels
+template<typename T>
+inline scalarVec<T>
+FMSub(const scalarVec<T> a, const scalarVec<T> b, const scalarVec<T> c) {
+    return {std::fma(a.v, b.v, -c.v)};
+}
+
+// m ? a : b
+template<typename T>
+inline scalarVec<T>
+Select(const bool m, const scalarVec<T> a, const scalarVec<T> b) {
+    return m ? a : b;
+}
+
+// m ? a + b : a
+template<typename T>
+inline scalarVec<T>
+AddIf(const bool m, const scalarVec<T> a, const scalarVec<T> b) {
+    return m ? a + b : a;
+}
+
+template<typename T>
+inline scalarVec<T> Abs(const scalarVec<T> a) {
+    return {std::fabs(a.v)};
+}
+template<typename T>
+inline scalarVec<T> Min(const scalarVec<T> a, const scalarVec<T> b) {
+    return {a.v < b.v ? a.v : b.v};
+}
+template<typename T>
+inline scalarVec<T> Max(const scalarVec<T> a, const scalarVec<T> b) {
+    return {a.v > b.v ? a.v : b.v};
+}
+
+// nearest whole number, ties to even
+template<typename T>
+inline scalarVec<T> Round(const scalarVec<T> a) {
+    return {std::nearbyint(a.v)};
+}
+
+// floor(log2 |a|) and |a| 2^-floor(log2 |a|) in [1, 2) of a normal a
+template<typename T>
+inline scalarVec<T> GetExponent(const scalarVec<T> a) {
+    return {static_cast<T>(std::ilogb(a.v))};
+}
+template<typename T>
+inline scalarVec<T> GetMantissa(const scalarVec<T> a) {
+    return {std::scalbn(std::fabs(a.v), -std::ilogb(a.v))};
+}
+
+// a 2^k for a whole k that keeps the result normal
+template<typename T>
+inline scalarVec<T> Scale(const scalarVec<T> a, const scalarVec<T> k) {
+    return {std::ldexp(a.v, static_cast<int>(k.v))};
+}
+
+inline bool Any(const bool m) {
+    return m;
+}
+
+// one bit per lane
+inline unsigned MoveMask(const bool m) {
+    return m ? 1u : 0u;
+}
+
+// base[index] for every lane, index holds whole numbers
+template<typename T>
+inline scalarVec<T> Gather(const T* base, const scalarVec<T> index) {
+    return {base[static_cast<std::size_t>(index.v)]};
+}
+
+#if defined(__AVX2__) && !defined(__AVX512F__)
+
+struct m32x8 {
+    __m256 v;
+};
+struct m64x4 {
+    __m256d v;
+};
+
+struct f32x8 {
+    using value_type = float;
+    using mask = m32x8;
+
+    static constexpr std::size_t width = 8;
+
+    __m256 v;
+
+    static f32x8 s_broadcast(const float x) {
+        return {_mm256_set1_ps(x)};
+    }
+    static f32x8 s_load(const float* p) {
+        return {_mm256_load_ps(p)};
+    }
+};
+
+struct f64x4 {
+    using value_type = double;
+    using mask = m64x4;
+
+    static constexpr std::size_t width = 4;
+
+    __m256d v;
+
+    static f64x4 s_broadcast(const double x) {
+        return {_mm256_set1_pd(x)};
+    }
+    static f64x4 s_load(const double* p) {
+        return {_mm256_load_pd(p)};
+    }
+};
+
+inline void Store(float* p, const f32x8 a) {
+    _mm256_store_ps(p, a.v);
+}
+inline void Store(double* p, const f64x4 a) {
+    _mm256_store_pd(p, a.v);
+}
+
+inline f32x8 operator+(const f32x8 a, const f32x8 b) {
+    return {_mm256_add_ps(a.v, b.v)};
+}
+inline f32x8 operator-(const f32x8 a, const f32x8 b) {
+    return {_mm256_sub_ps(a.v, b.v)};
+}
+inline f32x8 operator*(const f32x8 a, const f32x8 b) {
+    return {_mm256_mul_ps(a.v, b.v)};
+}
+inline f32x8 operator/(const f32x8 a, const f32x8 b) {
+    return {_mm256_div_ps(a.v, b.v)};
+}
+inline m32x8 operator<=(const f32x8 a, const f32x8 b) {
+    return {_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ)};
+}
+inline m32x8 operator>(const f32x8 a, const f32x8 b) {
+    return {_mm256_cmp_ps(a.v, b.v, _CMP_NLE_UQ)};
+}
+
+inline f64x4 operator+(const f64x4 a, const f64x4 b) {
+    return {_mm256_add_pd(a.v, b.v)};
+}
+inline f64x4 operator-(const f64x4 a, const f64x4 b) {
+    return {_mm256_sub_pd(a.v, b.v)};
+}
+inline f64x4 operator*(const f64x4 a, const f64x4 b) {
+    return {_mm256_mul_pd(a.v, b.v)};
+}
+inline f64x4 operator/(const f64x4 a, const f64x4 b) {
+    return {_mm256_div_pd(a.v, b.v)};
+}
+inline m64x4 operator<=(const f64x4 a, const f64x4 b) {
+    return {_mm256_cmp_pd(a.v, b.v, _CMP_LE_OQ)};
+}
+inline m64x4 operator>(const f64x4 a, const f64x4 b) {
+    return {_mm256_cmp_pd(a.v, b.v, _CMP_NLE_UQ)};
+}
+
+inline m32x8 operator&(const m32x8 a, const m32x8 b) {
+    return {_mm256_and_ps(a.v, b.v)};
+}
+inline m64x4 operator&(const m64x4 a, const m64x4 b) {
+    return {_mm256_and_pd(a.v, b.v)};
+}
+inline m32x8 operator|(const m32x8 a, const m32x8 b) {
+    return {_mm256_or_ps(a.v, b.v)};
+}
+inline m64x4 operator|(const m64x4 a, const m64x4 b) {
+    return {_mm256_or_pd(a.v, b.v)};
+}
+
+inline f32x8 FMAdd(const f32x8 a, const f32x8 b, const f32x8 c) {
+    return {_mm256_fmadd_ps(a.v, b.v, c.v)};
+}
+inline f64x4 FMAdd(const f64x4 a, const f64x4 b, const f64x4 c) {
+    return {_mm256_fmadd_pd(a.v, b.v, c.v)};
+}
+
+inline f32x8 FMSub(const f32x8 a, const f32x8 b, const f32x8 c) {
+    return {_mm256_fmsub_ps(a.v, b.v, c.v)};
+}
+inline f64x4 FMSub(const f64x4 a, const f64x4 b, const f64x4 c) {
+    return {_mm256_fmsub_pd(a.v, b.v, c.v)};
+}
+
+inline f32x8 Select(const m32x8 m, const f32x8 a, const f32x8 b) {
+    return {_mm256_blendv_ps(b.v, a.v, m.v)};
+}
+inline f64x4 Select(const m64x4 m, const f64x4 a, const f64x4 b) {
+    return {_mm256_blendv_pd(b.v, a.v, m.v)};
+}
+
+inline f32x8 AddIf(const m32x8 m, const f32x8 a, const f32x8 b) {
+    return {_mm256_add_ps(a.v, _mm256_and_ps(m.v, b.v))};
+}
+inline f64x4 AddIf(const m64x4 m, const f64x4 a, const f64x4 b) {
+    return {_mm256_add_pd(a.v, _mm256_and_pd(m.v, b.v))};
+}
+
+inline bool Any(const m32x8 m) {
+    return _mm256_movemask_ps(m.v) != 0;
+}
+inline bool Any(const m64x4 m) {
+    return _mm256_movemask_pd(m.v) != 0;
+}
+
+inline unsigned MoveMask(const m32x8 m) {
+    return static_cast<unsigned>(_mm256_movemask_ps(m.v));
+}
+inline unsigned MoveMask(const m64x4 m) {
+    return static_cast<unsigned>(_mm256_movemask_pd(m.v));
+}
+
+inline f32x8 Abs(const f32x8 a) {
+    return {_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)};
+}
+inline f64x4 Abs(const f64x4 a) {
+    return {_mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v)};
+}
+
+inline f32x8 Min(const f32x8 a, const f32x8 b) {
+    return {_mm256_min_ps(a.v, b.v)};
+}
+inline f64x4 Min(const f64x4 a, const f64x4 b) {
+    return {_mm256_min_pd(a.v, b.v)};
+}
+inline f32x8 Max(const f32x8 a, const f32x8 b) {
+    return {_mm256_max_ps(a.v, b.v)};
+}
+inline f64x4 Max(const f64x4 a, const f64x4 b) {
+    return {_mm256_max_pd(a.v, b.v)};
+}
+
+inline f32x8 Round(const f32x8 a) {
+    return {_mm256_round_ps(
+        a.v,
+        _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+}
+inline f64x4 Round(const f64x4 a) {
+    return {_mm256_round_pd(
+        a.v,
+        _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+}
+
+// the exponent and mantissa fields, there is no getexp before avx512
+inline f32x8 GetExponent(const f32x8 a) {
+    const __m256i bits = _mm256_srli_epi32(_mm256_castps_si256(Abs(a).v), 23);
+
+    return {_mm256_sub_ps(_mm256_cvtepi32_ps(bits), _mm256_set1_ps(127.0f))};
+}
+inline f64x4 GetExponent(const f64x4 a) {
+    // the biased exponent is below 2^52 so it turns into a double by
+    // putting it into the mantissa of 2^52
+    const __m256i bits = _mm256_srli_epi64(_mm256_castpd_si256(Abs(a).v), 52);
+    const __m256d twoTo52 = _mm256_set1_pd(0x1p52);
+
+    const __m256d biased = _mm256_sub_pd(
+        _mm256_castsi256_pd(
+            _mm256_or_si256(bits, _mm256_castpd_si256(twoTo52))),
+        twoTo52);
+
+    return {_mm256_sub_pd(biased, _mm256_set1_pd(1023.0))};
+}
+
+inline f32x8 GetMantissa(const f32x8 a) {
+    const __m256i fraction = _mm256_and_si256(
+        _mm256_castps_si256(a.v),
+        _mm256_set1_epi32(0x007fffff));
+
+    return {_mm256_castsi256_ps(
+        _mm256_or_si256(fraction, _mm256_castps_si256(_mm256_set1_ps(1.0f))))};
+}
+inline f64x4 GetMantissa(const f64x4 a) {
+    const __m256i fraction = _mm256_and_si256(
+        _mm256_castpd_si256(a.v),
+        _mm256_set1_epi64x(0x000fffffffffffff));
+
+    return {_mm256_castsi256_pd(
+        _mm256_or_si256(fraction, _mm256_castpd_si256(_mm256_set1_pd(1.0))))};
+}
+
+// 2^k is built in the exponent field
+inline f32x8 Scale(const f32x8 a, const f32x8 k) {
+    const __m256i biased =
+        _mm256_add_epi32(_mm256_cvtps_epi32(k.v), _mm256_set1_epi32(127));
+
+    return {_mm256_mul_ps(
+        a.v,
+        _mm256_castsi256_ps(_mm256_slli_epi32(biased, 23)))};
+}
+inline f64x4 Scale(const f64x4 a, const f64x4 k) {
+    const __m256i biased = _mm256_add_epi64(
+        _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(k.v)),
+        _mm256_set1_epi64x(1023));
+
+    return {_mm256_mul_pd(
+        a.v,
+        _mm256_castsi256_pd(_mm256_slli_epi64(biased, 52)))};
+}
+
+// the masked forms with a zero source keep gcc from warning about the
+// undefined source register of the plain ones
+inline f64x4 Gather(const double* base, const f64x4 index) {
+    const __m256d every = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+
+    return {_mm256_mask_i32gather_pd(
+        _mm256_setzero_pd(),
+        base,
+        _mm256_cvttpd_epi32(index.v),
+        every,
+        8)};
+}
+
+#endif
+
+#if defined(__AVX512F__)
+
+struct m32x16 {
+    __mmask16 v;
+};
+struct m64x8 {
+    __mmask8 v;
+};
+
+struct f32x16 {
+    using value_type = float;
+    using mask = m32x16;
+
+    static constexpr std::size_t width = 16;
+
+    __m512 v;
+
+    static f32x16 s_broadcast(const float x) {
+        return {_mm512_set1_ps(x)};
+    }
+    static f32x16 s_load(const float* p) {
+        return {_mm512_load_ps(p)};
+    }
+};
+
+struct f64x8 {
+    using value_type = double;
+    using mask = m64x8;
+
+    static constexpr std::size_t width = 8;
+
+    __m512d v;
+
+    static f64x8 s_broadcast(const double x) {
+        return {_mm512_set1_pd(x)};
+    }
+    static f64x8 s_load(const double* p) {
+        return {_mm512_load_pd(p)};
+    }
+};
+
+inline void Store(float* p, const f32x16 a) {
+    _mm512_store_ps(p, a.v);
+}
+inline void Store(double* p, const f64x8 a) {
+    _mm512_store_pd(p, a.v);
+}
+
+inline f32x16 operator+(const f32x16 a, const f32x16 b) {
+    return {_mm512_add_ps(a.v, b.v)};
+}
+inline f32x16 operator-(const f32x16 a, const f32x16 b) {
+    return {_mm512_sub_ps(a.v, b.v)};
+}
+inline f32x16 operator*(const f32x16 a, const f32x16 b) {
+    return {_mm512_mul_ps(a.v, b.v)};
+}
+inline f32x16 operator/(const f32x16 a, const f32x16 b) {
+    return {_mm512_div_ps(a.v, b.v)};
+}
+inline m32x16 operator<=(const f32x16 a, const f32x16 b) {
+    return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_LE_OQ)};
+}
+inline m32x16 operator>(const f32x16 a, const f32x16 b) {
+    return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_NLE_UQ)};
+}
+
+inline f64x8 operator+(const f64x8 a, const f64x8 b) {
+    return {_mm512_add_pd(a.v, b.v)};
+}
+inline f64x8 operator-(const f64x8 a, const f64x8 b) {
+    return {_mm512_sub_pd(a.v, b.v)};
+}
+inline f64x8 operator*(const f64x8 a, const f64x8 b) {
+    return {_mm512_mul_pd(a.v, b.v)};
+}
+inline f64x8 operator/(const f64x8 a, const f64x8 b) {
+    return {_mm512_div_pd(a.v, b.v)};
+}
+inline m64x8 operator<=(const f64x8 a, const f64x8 b) {
+    return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_LE_OQ)};
+}
+inline m64x8 operator>(const f64x8 a, const f64x8 b) {
+    return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_NLE_UQ)};
+}
+
+inline m32x16 operator&(const m32x16 a, const m32x16 b) {
+    return {static_cast<__mmask16>(a.v & b.v)};
+}
+inline m64x8 operator&(const m64x8 a, const m64x8 b) {
+    return {static_cast<__mmask8>(a.v & b.v)};
+}
+inline m32x16 operator|(const m32x16 a, const m32x16 b) {
+    return {static_cast<__mmask16>(a.v | b.v)};
+}
+inline m64x8 operator|(const m64x8 a, const m64x8 b) {
+    return {static_cast<__mmask8>(a.v | b.v)};
+}
+
+inline f32x16 FMAdd(const f32x16 a, const f32x16 b, const f32x16 c) {
+    return {_mm512_fmadd_ps(a.v, b.v, c.v)};
+}
+inline f64x8 FMAdd(const f64x8 a, const f64x8 b, const f64x8 c) {
+    return {_mm512_fmadd_pd(a.v, b.v, c.v)};
+}
+
+inline f32x16 FMSub(const f32x16 a, const f32x16 b, const f32x16 c) {
+    return {_mm512_fmsub_ps(a.v, b.v, c.v)};
+}
+inline f64x8 FMSub(const f64x8 a, const f64x8 b, const f64x8 c) {
+    return {_mm512_fmsub_pd(a.v, b.v, c.v)};
+}
+
+inline f32x16 Select(const m32x16 m, const f32x16 a, const f32x16 b) {
+    return {_mm512_mask_blend_ps(m.v, b.v, a.v)};
+}
+inline f64x8 Select(const m64x8 m, const f64x8 a, const f64x8 b) {
+    return {_mm512_mask_blend_pd(m.v, b.v, a.v)};
+}
+
+inline f32x16 AddIf(const m32x16 m, const f32x16 a, const f32x16 b) {
+    return {_mm512_mask_add_ps(a.v, m.v, a.v, b.v)};
+}
+inline f64x8 AddIf(const m64x8 m, const f64x8 a, const f64x8 b) {
+    return {_mm512_mask_add_pd(a.v, m.v, a.v, b.v)};
+}
+
+inline bool Any(const m32x16 m) {
+    return m.v != 0;
+}
+inline bool Any(const m64x8 m) {
+    return m.v != 0;
+}
+
+inline unsigned MoveMask(const m32x16 m) {
+    return m.v;
+}
+inline unsigned MoveMask(const m64x8 m) {
+    return m.v;
+}
+
+inline f32x16 Abs(const f32x16 a) {
+    return {_mm512_abs_ps(a.v)};
+}
+inline f64x8 Abs(const f64x8 a) {
+    return {_mm512_abs_pd(a.v)};
+}
+
+// masked forms with a zero source for the same reason as Gather
+inline f32x16 Min(const f32x16 a, const f32x16 b) {
+    return {_mm512_maskz_min_ps(0xffff, a.v, b.v)};
+}
+inline f64x8 Min(const f64x8 a, const f64x8 b) {
+    return {_mm512_maskz_min_pd(0xff, a.v, b.v)};
+}
+inline f32x16 Max(const f32x16 a, const f32x16 b) {
+    return {_mm512_maskz_max_ps(0xffff, a.v, b.v)};
+}
+inline f64x8 Max(const f64x8 a, const f64x8 b) {
+    return {_mm512_maskz_max_pd(0xff, a.v, b.v)};
+}
+
+inline f32x16 Round(const f32x16 a) {
+    return {_mm512_maskz_roundscale_ps(
+        0xffff,
+        a.v,
+        _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+}
+inline f64x8 Round(const f64x8 a) {
+    return {_mm512_maskz_roundscale_pd(
+        0xff,
+        a.v,
+        _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+}
+
+inline f32x16 GetExponent(const f32x16 a) {
+    return {_mm512_maskz_getexp_ps(0xffff, a.v)};
+}
+inline f64x8 GetExponent(const f64x8 a) {
+    return {_mm512_maskz_getexp_pd(0xff, a.v)};
+}
+
+inline f32x16 GetMantissa(const f32x16 a) {
+    return {_mm512_maskz_getmant_ps(
+        0xffff,
+        a.v,
+        _MM_MANT_NORM_1_2,
+        _MM_MANT_SIGN_zero)};
+}
+inline f64x8 GetMantissa(const f64x8 a) {
+    return {_mm512_maskz_getmant_pd(
+        0xff,
+        a.v,
+        _MM_MANT_NORM_1_2,
+        _MM_MANT_SIGN_zero)};
+}
+
+inline f32x16 Scale(const f32x16 a, const f32x16 k) {
+    return {_mm512_maskz_scalef_ps(0xffff, a.v, k.v)};
+}
+inline f64x8 Scale(const f64x8 a, const f64x8 k) {
+    return {_mm512_maskz_scalef_pd(0xff, a.v, k.v)};
+}
+
+inline f64x8 Gather(const double* base, const f64x8 index) {
+    return {_mm512_mask_i32gather_pd(
+        _mm512_setzero_pd(),
+        0xff,
+        _mm512_maskz_cvttpd_epi32(0xff, index.v),
+        base,
+        8)};
+}
+
+#endif
+
+// widest vectors of the unit that includes this file
+#if defined(__AVX512F__)
+using floatVec = f32x16;
+using doubleVec = f64x8;
+#elif defined(__AVX2__)
+using floatVec = f32x8;
+using doubleVec = f64x4;
+#else
+using floatVec = scalarVec<float>;
+using doubleVec = scalarVec<double>;
+#endif
+
+}  // namespace mandel::core::MANDEL_KERNEL_ISA::simd
@@ -0,0 +1,328 @@
+#pragma once
+
+// exp2, log2, pow, atan2 and sincos on whole vectors, for the polar form of
+// the multibrot step where the libm calls lane by lane cost more than the
+// rest of the iteration
+//
+// every function is a range reduction followed by a polynomial sized for
+// the lanes, float lanes get about 1e-7 and double lanes about 1e-15 of
+// relative error, the rounding of the iteration itself is no better, only
+// normal numbers are handled exactly and like simd.hpp it can only be
+// included by a kernel translation unit
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+#include "core/simd.hpp"
+
+namespace mandel::core::MANDEL_KERNEL_ISA::simd {
+
+template<typename T>
+struct mathCoefficients;
+
+template<>
+struct mathCoefficients<float> {
+    // e^u for |u| <= ln 2 / 2
+    static constexpr float exp[] = {
+        1.0f,
+        1.0f,
+        1.0f / 2.0f,
+        1.0f / 6.0f,
+        1.0f / 24.0f,
+        1.0f / 120.0f,
+        1.0f / 720.0f,
+        1.0f / 5040.0f};
+
+    // atanh(t) / t in t^2 for |t| <= 3 - 2 sqrt(2)
+    static constexpr float log[] = {
+        1.0f,
+        1.0f / 3.0f,
+        1.0f / 5.0f,
+        1.0f / 7.0f,
+        1.0f / 9.0f};
+
+    // atan(t) / t in t^2 for |t| <= tan(pi / 8), chebyshev fit
+    static constexpr float atan[] = {
+        0.99999999937122819f,
+        -0.33333306893048514f,
+        0.19998183041083206f,
+        -0.14239532669648974f,
+        0.10569828806414448f,
+        -0.060263052276584593f};
+
+    // (sin(r) / r - 1) / r^2 and (cos(r) - 1) / r^2 in r^2 for
+    // |r| <= pi / 4
+    static constexpr float sin[] = {
+        -1.0f / 6.0f,
+        1.0f / 120.0f,
+        -1.0f / 5040.0f,
+        1.0f / 362880.0f};
+    static constexpr float cos[] = {
+        -1.0f / 2.0f,
+        1.0f / 24.0f,
+        -1.0f / 720.0f,
+        1.0f / 40320.0f,
+        -1.0f / 3628800.0f};
+
+    // pi / 2 in three parts, the first two with few enough bits that
+    // multiples of them are exact
+    static constexpr float halfPi[] = {
+        1.5703125f,
+        4.837512969970703125e-4f,
+        7.54978995489188216e-8f};
+
+    // exponents of the normal range
+    static constexpr float minExponent = -126.0f;
+    static constexpr float maxExponent = 127.0f;
+};
+
+template<>
+struct mathCoefficients<double> {
+    static constexpr double exp[] = {
+        1.0,
+        1.0,
+        1.0 / 2.0,
+        1.0 / 6.0,
+        1.0 / 24.0,
+        1.0 / 120.0,
+        1.0 / 720.0,
+        1.0 / 5040.0,
+        1.0 / 40320.0,
+        1.0 / 362880.0,
+        1.0 / 3628800.0,
+        1.0 / 39916800.0,
+        1.0 / 479001600.0,
+        1.0 / 6227020800.0};
+
+    static constexpr double log[] = {
+        1.0,
+        1.0 / 3.0,
+        1.0 / 5.0,
+        1.0 / 7.0,
+        1.0 / 9.0,
+        1.0 / 11.0,
+        1.0 / 13.0,
+        1.0 / 15.0,
+        1.0 / 17.0,
+        1.0 / 19.0};
+
+    static constexpr double atan[] = {
+        1.0,
+        -0.33333333333328441,
+        0.19999999998855111,
+        -0.14285714180976467,
+        0.11111106180455946,
+        -0.090907730748084142,
+        0.076899534963068575,
+        -0.066402339304294081,
+        0.056883492268090106,
+        -0.043480522157164629,
+        0.021135373157693246};
+
+    static constexpr double sin[] = {
+        -1.0 / 6.0,
+        1.0 / 120.0,
+        -1.0 / 5040.0,
+        1.0 / 362880.0,
+        -1.0 / 39916800.0,
+        1.0 / 6227020800.0,
+        -1.0 / 1307674368000.0};
+    static constexpr double cos[] = {
+        -1.0 / 2.0,
+        1.0 / 24.0,
+        -1.0 / 720.0,
+        1.0 / 40320.0,
+        -1.0 / 3628800.0,
+        1.0 / 479001600.0,
+        -1.0 / 87178291200.0,
+        1.0 / 20922789888000.0};
+
+    static constexpr double halfPi[] = {
+        1.57079632673412561417e+00,
+        6.07710050630396597660e-11,
+        2.02226624879595063154e-21};
+
+    static constexpr double minExponent = -1022.0;
+    static constexpr double maxExponent = 1023.0;
+};
+
+// c[0] + c[1] x + c[2] x^2 + ...
+template<typename V, std::size_t n>
+inline V Polynomial(const V x, const typename V::value_type (&c)[n]) {
+    V result = V::s_broadcast(c[n - 1]);
+
+    for (std::size_t i = n - 1; i-- > 0;)
+        result = FMAdd(result, x, V::s_broadcast(c[i]));
+
+    return result;
+}
+
+// 2^x, clamped to the normal range
+template<typename V>
+inline V Exp2(const V x) {
+    using T = typename V::value_type;
+    using coefficients = mathCoefficients<T>;
+
+    const V clamped = Min(
+        Max(x, V::s_broadcast(coefficients::minExponent)),
+        V::s_broadcast(coefficients::maxExponent));
+
+    // 2^x = 2^k e^(f ln 2) with |f| <= 1 / 2
+    const V k = Round(clamped);
+    const V u = (clamped - k) * V::s_broadcast(T(0.693147180559945309417));
+
+    return Scale(Polynomial(u, coefficients::exp), k);
+}
+
+// log2 x, -inf for 0 and below
+template<typename V>
+inline V Log2(const V x) {
+    using T = typename V::value_type;
+    using coefficients = mathCoefficients<T>;
+
+    const V one = V::s_broadcast(T(1));
+
+    // x = 2^k m with m in [sqrt(1 / 2), sqrt(2))
+    V k = GetExponent(x);
+    V m = GetMantissa(x);
+
+    const auto high = m > V::s_broadcast(T(1.41421356237309504880));
+
+    m = Select(high, m * V::s_broadcast(T(0.5)), m);
+    k = Select(high, k + one, k);
+
+    // ln m = 2 atanh t
+    const V t = (m - one) / (m + one);
+    const V ln = (t + t) * Polynomial(t * t, coefficients::log);
+
+    const V result = FMAdd(ln, V::s_broadcast(T(1.44269504088896340736)), k);
+
+    return Select(
+        x > V::s_broadcast(T(0)),
+        result,
+        V::s_broadcast(-std::numeric_limits<T>::infinity()));
+}
+
+// x^y of x >= 0
+template<typename V>
+inline V Pow(const V x, const V y) {
+    return Exp2(y * Log2(x));
+}
+
+// the angle of (x, y) in [-pi, pi], 0 for the origin
+template<typename V>
+inline V Atan2(const V y, const V x) {
+    using T = typename V::value_type;
+    using coefficients = mathCoefficients<T>;
+
+    const V zero = V::s_broadcast(T(0));
+    const V pi = V::s_broadcast(T(3.14159265358979323846));
+    const V halfPi = V::s_broadcast(T(1.57079632679489661923));
+    const V quarterPi = V::s_broadcast(T(0.78539816339744830962));
+
+    const V absX = Abs(x);
+    const V absY = Abs(y);
+
+    // atan of a = small / large in [0, 1], above tan(pi / 8) it is
+    // pi / 4 + atan((a - 1) / (a + 1)), one division for both
+    const V small = Min(absX, absY);
+    const V large = Max(absX, absY);
+
+    const auto reduce =
+        small > large * V::s_broadcast(T(0.41421356237309504880));
+
+    const V numerator = Select(reduce, small - large, small);
+    const V denominator = Select(reduce, small + large, large);
+
+    const V t = Select(
+        denominator > zero,
+        numerator / denominator,
+        zero);
+
+    V angle = t * Polynomial(t * t, coefficients::atan);
+
+    angle = Select(reduce, angle + quarterPi, angle);
+    angle = Select(absY > absX, halfPi - angle, angle);
+    angle = Select(zero > x, pi - angle, angle);
+
+    return Select(zero > y, zero - angle, angle);
+}
+
+// sin and cos of a
+template<typename V>
+inline void SinCos(const V a, V& sin, V& cos) {
+    using T = typename V::value_type;
+    using coefficients = mathCoefficients<T>;
+
+    const V zero = V::s_broadcast(T(0));
+    const V one = V::s_broadcast(T(1));
+    const V half = V::s_broadcast(T(0.5));
+    const V threeHalves = V::s_broadcast(T(1.5));
+
+    // a = q pi / 2 + r with |r| <= pi / 4
+    const V q = Round(a * V::s_broadcast(T(0.63661977236758134308)));
+
+    V r = a - q * V::s_broadcast(coefficients::halfPi[0]);
+    r = r - q * V::s_broadcast(coefficients::halfPi[1]);
+    r = r - q * V::s_broadcast(coefficients::halfPi[2]);
+
+    const V r2 = r * r;
+
+    const V s = FMAdd(r * r2, Polynomial(r2, coefficients::sin), r);
+    const V c = FMAdd(r2, Polynomial(r2, coefficients::cos), one);
+
+    // the quadrant q mod 4 as -2, -1, 0, 1 or 2 where -2 and 2 are the same
+    const V quarter = q * V::s_broadcast(T(0.25));
+    const V quadrant = (quarter - Round(quarter)) * V::s_broadcast(T(4));
+    const V absQuadrant = Abs(quadrant);
+
+    const auto swap = (absQuadrant > half) & (threeHalves > absQuadrant);
+    const auto opposite = absQuadrant > threeHalves;
+    const auto negativeSin = opposite | (zero - half > quadrant);
+    const auto negativeCos = opposite | (quadrant > half);
+
+    const V sinR = Select(swap, c, s);
+    const V cosR = Select(swap, s, c);
+
+    sin = Select(negativeSin, zero - sinR, sinR);
+    cos = Select(negativeCos, zero - cosR, cosR);
+}
+
+// z^exponent + c of the polar form |z|^n (cos n arg z + i sin n arg z)
+// for a whole vector of lanes, r2 is |z|^2
+template<typename V>
+inline void PolarStep(
+    V& x,
+    V& y,
+    const V r2,
+    const V cx,
+    const V cy,
+    const V exponent) {
+    const V power =
+        Pow(r2, exponent * V::s_broadcast(typename V::value_type(0.5)));
+
+    V sin, cos;
+    SinCos(exponent * Atan2(y, x), sin, cos);
+
+    x = FMAdd(power, cos, cx);
+    y = FMAdd(power, sin, cy);
+}
+
+// one lane at a time libm is faster than the polynomials
+template<typename T>
+inline void PolarStep(
+    scalarVec<T>& x,
+    scalarVec<T>& y,
+    const scalarVec<T> r2,
+    const scalarVec<T> cx,
+    const scalarVec<T> cy,
+    const scalarVec<T> exponent) {
+    const T power = std::pow(r2.v, exponent.v * T(0.5));
+    const T angle = exponent.v * std::atan2(y.v, x.v);
+
+    x.v = power * std::cos(angle) + cx.v;
+    y.v = power * std::sin(angle) + cy.v;
+}
+
+}  // namespace mandel::core::MANDEL_KERNEL_ISA::simd
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mandel::core {
+
+// fork join pool with one task deque per worker, a worker pops its own
+// deque from the back and steals from the front of the others once it runs
+// dry so cheap and expensive tasks even out between the threads
+class threadPool {
+  public:
+    // func(task, worker), worker is in [0, m_threadCount())
+    using taskFunc = std::function<void(std::size_t, std::size_t)>;
+
+    // 0 threads means one per hardware thread
+    explicit threadPool(const std::size_t threadCount = 0);
+    ~threadPool();
+
+    threadPool(const threadPool&) = delete;
+    threadPool& operator=(const threadPool&) = delete;
+
+    // the calling thread of m_run counts as worker 0
+    [[nodiscard]] std::size_t m_threadCount() const noexcept {
+        return m_queues.size();
+    }
+
+    void m_resize(std::size_t threadCount);
+
+    // runs func for every task in [0, taskCount) and blocks until all of
+    // them are done
+    void m_run(const std::size_t taskCount, const taskFunc& func);
+
+    // tasks that ran on another worker than they were queued on during the
+    // last m_run
+    [[nodiscard]] std::size_t m_stealCount() const noexcept {
+        return m_steals.load(std::memory_order_relaxed);
+    }
+
+  private:
+    struct taskQueue {
+        std::mutex mutex;
+        std::deque<std::size_t> tasks;
+    };
+
+    void m_start(const std::size_t threadCount);
+    void m_stop();
+
+    void m_workerLoop(const std::size_t worker, std::size_t generation);
+    void m_work(const std::size_t worker);
+
+    bool m_pop(const std::size_t worker, std::size_t& task);
+    bool m_steal(const std::size_t worker, std::size_t& task);
+
+    std::vector<std::unique_ptr<taskQueue>> m_queues;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeUp;
+    std::condition_variable m_finished;
+
+    const taskFunc* m_func = nullptr;
+    std::size_t m_generation = 0;
+    std::size_t m_busyWorkers = 0;
+    bool m_quit = false;
+
+    std::atomic<std::size_t> m_steals {0};
+};
+
+}  // namespace mandel::core
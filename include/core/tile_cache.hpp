@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "core/kernel.hpp"
+#include "core/view.hpp"
+
+namespace mandel::core {
+
+struct tileCacheStats {
+    // frame tiles the cache had or put together from the level below, and
+    // the ones it did not have, since the last m_clear
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    // tiles dropped to stay in the budget
+    std::size_t evictions = 0;
+
+    // what the cache holds now
+    std::size_t tiles = 0;
+    std::size_t bytes = 0;
+};
+
+// iterations of earlier frames kept as square tiles of the complex plane,
+// so coming back to a place, zooming back out or leaving a julia view only
+// computes the tiles that were never seen
+//
+// the samples of level l are the points anchor + 2^l (i, j), a sheet holds
+// the levels of one anchor and set and its tiles are keyed by level and
+// place, a frame takes every pixel from the nearest sample of the coarsest
+// level that is not coarser than its pixels, which moves pixels by up to
+// half a sample and so by half a pixel at most, every sample of level l + 1
+// is one of level l so a missing tile is put together from the four below
+// it when they are there, the least recently used tiles are dropped past
+// the budget
+//
+// the anchor is a whole number of samples of the level its sheet is made
+// at and of the ones up to 16 above it, which keeps their samples on the
+// lattice of GetKernelParams
+class tileCache {
+  public:
+    // width and height of a tile in samples
+    static constexpr int tileSize = 64;
+
+    // added to sample coordinates before they are truncated, far past the
+    // samples a frame can be from its anchor
+    static constexpr double sampleBias = 4294967296.0;  // 2^32
+
+    // the samples of a tile, row major, shared so a frame keeps the tiles it
+    // took while the cache drops them
+    using tileData = std::shared_ptr<std::vector<int>>;
+
+    // the samples a frame takes
+    struct frameLayout {
+        std::size_t sheet = 0;
+        int level = 0;
+
+        // pixel (x, y) takes sample (floor(originX + x stepXx + y stepYx),
+        // floor(originY + x stepXy + y stepYy))
+        double originX = 0.0, originY = 0.0;
+        double stepXx = 0.0, stepXy = 0.0;
+        double stepYx = 0.0, stepYy = 0.0;
+
+        // pixels the tiles of the frame reach past its border
+        int margin = 0;
+
+        void m_getSample(
+            const int x,
+            const int y,
+            std::int64_t& i,
+            std::int64_t& j) const {
+            const double fx = static_cast<double>(x);
+            const double fy = static_cast<double>(y);
+
+            // truncating the positive sum floors it
+            i = static_cast<std::int64_t>(
+                    originX + fx * stepXx + fy * stepYx + sampleBias)
+                - static_cast<std::int64_t>(sampleBias);
+            j = static_cast<std::int64_t>(
+                    originY + fx * stepXy + fy * stepYy + sampleBias)
+                - static_cast<std::int64_t>(sampleBias);
+        }
+    };
+
+    // bytes the tiles may take, 0 drops them all and turns the cache off
+    void m_setBudget(const std::size_t bytes);
+
+    // drops every tile and sheet and resets the stats
+    void m_clear();
+
+    // the samples of a width x height frame of v, adds a sheet for it when
+    // no sheet has its set and reaches its center
+    frameLayout m_getLayout(const view& v, const int width, const int height);
+
+    // the tileSize x tileSize view of v whose pixels are the samples of
+    // tile (x, y) of the level of layout
+    [[nodiscard]] view m_getTileView(
+        const view& v,
+        const frameLayout& layout,
+        const std::int64_t x,
+        const std::int64_t y) const;
+
+    // tile (x, y) of the level of layout, from the cache or put together
+    // from the level below, null when it has to be computed
+    tileData m_find(
+        const frameLayout& layout,
+        const precision floatType,
+        const std::int64_t x,
+        const std::int64_t y);
+
+    // keeps a computed tile
+    void m_insert(
+        const frameLayout& layout,
+        const precision floatType,
+        const std::int64_t x,
+        const std::int64_t y,
+        tileData data);
+
+    [[nodiscard]] const tileCacheStats& stats() const noexcept {
+        return m_stats;
+    }
+
+  private:
+    struct sheet {
+        // the set, its place and increment do not count
+        view set;
+        bigVec2 anchor;
+        std::size_t tiles = 0;
+        std::uint64_t lastUse = 0;
+    };
+
+    struct tileKey {
+        std::size_t sheet;
+        int level;
+        precision floatType;
+        std::int64_t x, y;
+
+        bool operator==(const tileKey& other) const noexcept {
+            return sheet == other.sheet && level == other.level
+                && floatType == other.floatType && x == other.x
+                && y == other.y;
+        }
+    };
+
+    struct tileKeyHash {
+        std::size_t operator()(const tileKey& key) const noexcept;
+    };
+
+    struct tile {
+        tileKey key;
+        tileData data;
+    };
+
+    // the tile of key, marked as most recently used, null when there is none
+    tileData m_get(const tileKey& key);
+
+    void m_put(const tileKey& key, tileData data);
+
+    void m_erase(const std::list<tile>::iterator it);
+
+    // drops least recently used tiles until the budget holds extra bytes
+    // more
+    void m_evict(const std::size_t extra);
+
+    std::size_t m_budget = 0;
+
+    std::vector<sheet> m_sheets;
+    std::uint64_t m_useCount = 0;
+
+    // most recently used first
+    std::list<tile> m_tiles;
+    std::unordered_map<tileKey, std::list<tile>::iterator, tileKeyHash>
+        m_index;
+
+    tileCacheStats m_stats;
+};
+
+}  // namespace mandel::core
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "core/big_float.hpp"
+#include "vec4.hpp"
+
+namespace mandel::core {
+
+// the state fragment.glsl gets through its uniforms
+struct view {
+    // complex plane location of the screen center, exact so deep zooms can
+    // iterate a reference orbit from it
+    bigVec2 startPos {0.0, 0.0};
+    // addition per pixel in the complex plane, times 2^incrementScale
+    vec4<double> increment {4.0 / 640.0, 4.0 / 640.0};
+    // 0 unless the increment is past the range of double
+    int incrementScale = 0;
+    // rotation vector for rotating the set (cos, sin)
+    vec4<double> rotation {1.0, 0.0};
+    // max number to stop computing
+    int maxIteration = 100;
+
+    bool bUseJuliaSet = false;
+    vec4<double> juliaConstant {0.0, 0.0};
+
+    double exponent = 2.0;
+};
+
+struct palette {
+    // three rgb colors
+    float colorPalette[9] = {
+        1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+
+    float colorPeriod = 0.1f;
+};
+
+// whether frames of a and b show the same iterations, the julia constant
+// only counts for julia views
+bool IsSameView(const view& a, const view& b);
+
+// whether b is a with the center moved by whole pixels, the pixel (x, y) of
+// a frame of b is then (x + offsetX, y + offsetY) of a frame of a of the same
+// size
+bool GetPixelOffset(const view& a, const view& b, int& offsetX, int& offsetY);
+
+}  // namespace mandel::core
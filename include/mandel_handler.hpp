@@ -1,4 +1,5 @@
 #pragma once
+#include "core/view.hpp"
 #include "shader.hpp"
 
 namespace mandel {
@@ -18,4 +19,8 @@ void ZoomMandel(
 void MoveMandel(const vec4<float> movement);
 
 void DrawUniforms_ImGui(const vec4<int> screenSize);
+
+// current state for the cpu renderer
+core::view GetMandelView();
+core::palette GetMandelPalette();
 }  // namespace mandel
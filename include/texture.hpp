@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+#include "utility.hpp"
+
+namespace mandel::gl {
+
+class texture: public __baseObject {
+  public:
+    texture();
+    ~texture();
+
+    void m_create();
+
+    void m_bind() const override;
+    void m_unbind() const override;
+
+    // upload width x height rgba8 pixels, reallocates on a size change
+    void m_setData(const int width, const int height, const std::uint8_t* rgba);
+
+  private:
+    int m_width = 0;
+    int m_height = 0;
+};
+
+}  // namespace mandel::gl
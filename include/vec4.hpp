@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+
+namespace mandel {
+
+template<typename T>
+class vec4 {
+  public:
+    union {
+        struct {
+            T x, y, z, w;
+        };
+        struct {
+            T r, g, b, a;
+        };
+    };
+
+    vec4(const T& vx, const T& vy, const T& vz, const T& vw) :
+        x(vx),
+        y(vy),
+        z(vz),
+        w(vw) {}
+    vec4(const T& vx, const T& vy, const T& vz) :
+        vec4<T>::vec4(vx, vy, vz, 0) {}
+    vec4(const T& vx, const T& vy) : vec4<T>::vec4(vx, vy, 0, 0) {}
+    vec4(const T& v) : vec4<T>::vec4(v, v, v, v) {}
+    vec4() : vec4<T>::vec4(0, 0, 0, 0) {}
+
+    constexpr vec4<T> operator+(const vec4<T>& v) const noexcept {
+        return {x + v.x, y + v.y, z + v.z, w + v.w};
+    }
+    constexpr vec4<T> operator-(const vec4<T>& v) const noexcept {
+        return {x - v.x, y - v.y, z - v.z, w - v.w};
+    }
+    constexpr vec4<T> operator*(const vec4<T>& v) const noexcept {
+        return {x * v.x, y * v.y, z * v.z, w * v.w};
+    }
+    constexpr vec4<T> operator/(const vec4<T>& v) const noexcept {
+        return {x / v.x, y / v.y, z / v.z, w / v.w};
+    }
+
+    constexpr vec4<T>& operator+=(const vec4<T>& v) noexcept {
+        return *this = *this + v;
+    }
+    constexpr vec4<T>& operator-=(const vec4<T>& v) noexcept {
+        return *this = *this - v;
+    }
+    constexpr vec4<T>& operator*=(const vec4<T>& v) noexcept {
+        return *this = *this * v;
+    }
+    constexpr vec4<T>& operator/=(const vec4<T>& v) noexcept {
+        return *this = *this / v;
+    }
+
+    constexpr const T& operator[](const std::size_t i) const {
+        if (i >= 4)
+            throw "vec4<T>::operator[] out of range index";
+
+        return *(&x + i);
+    }
+    constexpr T& operator[](const std::size_t i) {
+        return const_cast<T&>(const_cast<const vec4<T>&>(*this)[i]);
+    }
+
+    template<typename newT>
+    constexpr operator vec4<newT>() const {
+        return {
+            static_cast<newT>(x),
+            static_cast<newT>(y),
+            static_cast<newT>(z),
+            static_cast<newT>(w)};
+    }
+
+    friend inline std::ostream& operator<<(std::ostream& o, const vec4<T>& v) {
+        o << "[vec4<T>](x = " << v.x << ", y = " << v.y << ", z = " << v.z
+          << ", w = " << v.w << ")";
+        return o;
+    }
+};
+
+}  // namespace mandel
@@ -0,0 +1,12 @@
+#version 330 core
+
+// shows a frame rendered by mandel_core
+
+layout(origin_upper_left) in vec4 gl_FragCoord;
+
+uniform sampler2D u_frame;
+
+void main()
+{
+    gl_FragColor = texelFetch(u_frame, ivec2(gl_FragCoord.xy), 0);
+}
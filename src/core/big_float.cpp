@@ -0,0 +1,392 @@
+#include "core/big_float.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/big_multiply.hpp"
+
+namespace mandel::core {
+namespace {
+    std::size_t getLimbCount(const std::size_t precision) {
+        return std::max<std::size_t>(1, (precision + 31) / 32);
+    }
+
+    int countLeadingZeros(const std::uint32_t v) {
+        int result = 0;
+
+        for (std::uint32_t bit = 0x80000000u; bit != 0 && (v & bit) == 0;
+             bit >>= 1)
+            ++result;
+
+        return result;
+    }
+
+    // src top aligned into dst and shifted right by shift bits, bits that
+    // fall off the bottom are dropped
+    void alignInto(
+        const std::vector<std::uint32_t>& src,
+        const std::uint64_t shift,
+        std::vector<std::uint32_t>& dst) {
+        const std::size_t size = dst.size();
+
+        std::fill(dst.begin(), dst.end(), 0u);
+
+        if (shift >= static_cast<std::uint64_t>(size) * 32)
+            return;
+
+        const std::size_t limbShift = shift / 32;
+        const unsigned bitShift = static_cast<unsigned>(shift % 32);
+
+        // limb i of src sits at offset + i in dst before the shift
+        const std::size_t offset = size - std::min(size, src.size());
+        const std::size_t skipped = src.size() - (size - offset);
+
+        const auto topAligned = [&](const std::size_t j) -> std::uint32_t {
+            if (j < offset || j >= size)
+                return 0;
+            return src[j - offset + skipped];
+        };
+
+        for (std::size_t j = 0; j + limbShift < size; ++j) {
+            const std::size_t from = j + limbShift;
+
+            std::uint32_t v = topAligned(from) >> bitShift;
+            if (bitShift != 0)
+                v |= topAligned(from + 1) << (32 - bitShift);
+
+            dst[j] = v;
+        }
+    }
+
+    // shifts left until the top bit of the top limb is set and returns the
+    // shift, or returns -1 when every limb is zero
+    std::int64_t normalizeLimbs(std::vector<std::uint32_t>& limbs) {
+        const std::size_t size = limbs.size();
+
+        std::size_t top = size;
+        while (top > 0 && limbs[top - 1] == 0)
+            --top;
+
+        if (top == 0)
+            return -1;
+
+        const std::size_t limbShift = size - top;
+        const int bitShift = countLeadingZeros(limbs[top - 1]);
+
+        if (limbShift != 0) {
+            for (std::size_t j = size; j-- > limbShift;)
+                limbs[j] = limbs[j - limbShift];
+            std::fill_n(limbs.begin(), limbShift, 0u);
+        }
+
+        if (bitShift != 0) {
+            for (std::size_t j = size; j-- > 1;) {
+                limbs[j] = (limbs[j] << bitShift)
+                    | (limbs[j - 1] >> (32 - bitShift));
+            }
+            limbs[0] <<= bitShift;
+        }
+
+        return static_cast<std::int64_t>(limbShift) * 32 + bitShift;
+    }
+}  // namespace
+
+bigFloat::bigFloat() : m_limbs(getLimbCount(s_defaultPrecision), 0u) {}
+
+bigFloat::bigFloat(const double v, const std::size_t precision) :
+    m_limbs(getLimbCount(precision), 0u) {
+    if (v == 0.0 || !std::isfinite(v))
+        return;
+
+    int exp;
+    const double fraction = std::frexp(std::fabs(v), &exp);
+
+    // 53 bits of mantissa fit into the top two limbs
+    const std::uint64_t bits =
+        static_cast<std::uint64_t>(std::ldexp(fraction, 64));
+
+    const std::size_t size = m_limbs.size();
+
+    m_limbs[size - 1] = static_cast<std::uint32_t>(bits >> 32);
+    if (size > 1)
+        m_limbs[size - 2] = static_cast<std::uint32_t>(bits);
+
+    m_exp = exp;
+    m_negative = v < 0.0;
+    m_zero = false;
+}
+
+void bigFloat::m_setPrecision(const std::size_t precision) {
+    const std::size_t size = getLimbCount(precision);
+
+    if (size > m_limbs.size())
+        m_limbs.insert(m_limbs.begin(), size - m_limbs.size(), 0u);
+    else if (size < m_limbs.size())
+        m_limbs.erase(
+            m_limbs.begin(),
+            m_limbs.begin()
+                + static_cast<std::ptrdiff_t>(m_limbs.size() - size));
+}
+
+double bigFloat::m_toDouble() const {
+    if (m_zero)
+        return 0.0;
+
+    const std::size_t size = m_limbs.size();
+
+    std::uint64_t bits = static_cast<std::uint64_t>(m_limbs[size - 1]) << 32;
+    if (size > 1)
+        bits |= m_limbs[size - 2];
+
+    const std::int64_t exp = std::clamp<std::int64_t>(m_exp - 64, -4000, 4000);
+    const double result =
+        std::ldexp(static_cast<double>(bits), static_cast<int>(exp));
+
+    return m_negative ? -result : result;
+}
+
+bigFloat bigFloat::m_ldexp(const std::int64_t k) const {
+    bigFloat result = *this;
+
+    if (!m_zero)
+        result.m_exp += k;
+
+    return result;
+}
+
+bigFloat bigFloat::m_floor() const {
+    const std::int64_t precision = static_cast<std::int64_t>(m_precision());
+
+    // every bit is at 2^0 or above
+    if (m_zero || m_exp >= precision)
+        return *this;
+
+    const bigFloat one(1.0, m_precision());
+
+    if (m_exp <= 0)
+        return m_negative ? -one : bigFloat(0.0, m_precision());
+
+    // the lowest precision - exponent bits are below 2^0
+    const std::int64_t fractionBits = precision - m_exp;
+
+    bigFloat result = *this;
+    bool bFraction = false;
+
+    for (std::int64_t low = 0; low < fractionBits; low += 32) {
+        std::uint32_t& limb =
+            result.m_limbs[static_cast<std::size_t>(low / 32)];
+
+        const std::int64_t bits = fractionBits - low;
+        const std::uint32_t mask =
+            bits >= 32 ? 0xffffffffu : (1u << bits) - 1u;
+
+        bFraction = bFraction || (limb & mask) != 0;
+        limb &= ~mask;
+    }
+
+    // clearing the fraction rounded towards zero
+    if (m_negative && bFraction)
+        result -= one;
+
+    return result;
+}
+
+bigFloat bigFloat::operator-() const {
+    bigFloat result = *this;
+
+    if (!m_zero)
+        result.m_negative = !m_negative;
+
+    return result;
+}
+
+int bigFloat::s_compareMagnitudes(const bigFloat& a, const bigFloat& b) {
+    if (a.m_zero || b.m_zero)
+        return static_cast<int>(!a.m_zero) - static_cast<int>(!b.m_zero);
+
+    if (a.m_exp != b.m_exp)
+        return a.m_exp < b.m_exp ? -1 : 1;
+
+    // compare from the top, missing low limbs are zero
+    const std::size_t sizeA = a.m_limbs.size();
+    const std::size_t sizeB = b.m_limbs.size();
+
+    for (std::size_t i = 0; i < std::max(sizeA, sizeB); ++i) {
+        const std::uint32_t limbA = i < sizeA ? a.m_limbs[sizeA - 1 - i] : 0;
+        const std::uint32_t limbB = i < sizeB ? b.m_limbs[sizeB - 1 - i] : 0;
+
+        if (limbA != limbB)
+            return limbA < limbB ? -1 : 1;
+    }
+
+    return 0;
+}
+
+// |a| + |b| with the exponent of a at least the one of b
+bigFloat bigFloat::s_addMagnitudes(
+    const bigFloat& a,
+    const bigFloat& b,
+    const bool negative) {
+    const std::size_t size = std::max(a.m_limbs.size(), b.m_limbs.size());
+
+    // one guard limb under the result
+    std::vector<std::uint32_t> sumA(size + 1), sumB(size + 1);
+
+    alignInto(a.m_limbs, 0, sumA);
+    alignInto(b.m_limbs, static_cast<std::uint64_t>(a.m_exp - b.m_exp), sumB);
+
+    std::uint64_t carry = 0;
+    for (std::size_t i = 0; i <= size; ++i) {
+        carry += static_cast<std::uint64_t>(sumA[i]) + sumB[i];
+        sumA[i] = static_cast<std::uint32_t>(carry);
+        carry >>= 32;
+    }
+
+    bigFloat result;
+    result.m_exp = a.m_exp;
+
+    if (carry != 0) {
+        for (std::size_t i = 0; i < size; ++i)
+            sumA[i] = (sumA[i] >> 1) | (sumA[i + 1] << 31);
+        sumA[size] = (sumA[size] >> 1) | 0x80000000u;
+
+        ++result.m_exp;
+    }
+
+    result.m_limbs.assign(sumA.begin() + 1, sumA.end());
+    result.m_negative = negative;
+    result.m_zero = false;
+
+    return result;
+}
+
+// |a| - |b| with |a| > |b|
+bigFloat bigFloat::s_subMagnitudes(
+    const bigFloat& a,
+    const bigFloat& b,
+    const bool negative) {
+    const std::size_t size = std::max(a.m_limbs.size(), b.m_limbs.size());
+
+    std::vector<std::uint32_t> diff(size + 1), sub(size + 1);
+
+    alignInto(a.m_limbs, 0, diff);
+    alignInto(b.m_limbs, static_cast<std::uint64_t>(a.m_exp - b.m_exp), sub);
+
+    std::int64_t borrow = 0;
+    for (std::size_t i = 0; i <= size; ++i) {
+        std::int64_t v = static_cast<std::int64_t>(diff[i]) - sub[i] - borrow;
+
+        borrow = v < 0 ? 1 : 0;
+        if (v < 0)
+            v += std::int64_t(1) << 32;
+
+        diff[i] = static_cast<std::uint32_t>(v);
+    }
+
+    bigFloat result;
+    result.m_exp = a.m_exp;
+
+    const std::int64_t shift = normalizeLimbs(diff);
+    if (shift < 0) {
+        result.m_limbs.assign(size, 0u);
+        return result;
+    }
+
+    result.m_exp -= shift;
+    result.m_limbs.assign(diff.begin() + 1, diff.end());
+    result.m_negative = negative;
+    result.m_zero = false;
+
+    return result;
+}
+
+bigFloat operator+(const bigFloat& a, const bigFloat& b) {
+    if (b.m_zero || a.m_zero) {
+        bigFloat result = b.m_zero ? a : b;
+        result.m_setPrecision(std::max(a.m_precision(), b.m_precision()));
+        return result;
+    }
+
+    const bool aLarger = a.m_exp >= b.m_exp;
+
+    if (a.m_negative == b.m_negative) {
+        return aLarger ? bigFloat::s_addMagnitudes(a, b, a.m_negative)
+                       : bigFloat::s_addMagnitudes(b, a, a.m_negative);
+    }
+
+    const int cmp = bigFloat::s_compareMagnitudes(a, b);
+
+    if (cmp == 0) {
+        bigFloat result;
+        result.m_setPrecision(std::max(a.m_precision(), b.m_precision()));
+        return result;
+    }
+
+    return cmp > 0 ? bigFloat::s_subMagnitudes(a, b, a.m_negative)
+                   : bigFloat::s_subMagnitudes(b, a, b.m_negative);
+}
+
+bigFloat operator-(const bigFloat& a, const bigFloat& b) {
+    return a + -b;
+}
+
+bigFloat operator*(const bigFloat& a, const bigFloat& b) {
+    const std::size_t size = std::max(a.m_limbs.size(), b.m_limbs.size());
+
+    bigFloat result;
+
+    if (a.m_zero || b.m_zero) {
+        result.m_limbs.assign(size, 0u);
+        return result;
+    }
+
+    const std::size_t sizeA = a.m_limbs.size();
+    const std::size_t sizeB = b.m_limbs.size();
+
+    // the algorithm goes by the size of the mantissas
+    std::vector<std::uint32_t> product(sizeA + sizeB);
+
+    MultiplyLimbs(
+        a.m_limbs.data(),
+        sizeA,
+        b.m_limbs.data(),
+        sizeB,
+        product.data());
+
+    // the product of two mantissas in [0.5, 1) is at least 0.25
+    const std::int64_t shift = normalizeLimbs(product);
+
+    result.m_limbs.assign(
+        product.begin() + static_cast<std::ptrdiff_t>(sizeA + sizeB - size),
+        product.end());
+    result.m_exp = a.m_exp + b.m_exp - shift;
+    result.m_negative = a.m_negative != b.m_negative;
+    result.m_zero = false;
+
+    return result;
+}
+
+bool operator==(const bigFloat& a, const bigFloat& b) {
+    if (a.m_zero || b.m_zero)
+        return a.m_zero == b.m_zero;
+
+    return a.m_negative == b.m_negative
+        && bigFloat::s_compareMagnitudes(a, b) == 0;
+}
+
+bool operator<(const bigFloat& a, const bigFloat& b) {
+    if (a.m_zero && b.m_zero)
+        return false;
+
+    const bool negativeA = !a.m_zero && a.m_negative;
+    const bool negativeB = !b.m_zero && b.m_negative;
+
+    if (negativeA != negativeB)
+        return negativeA;
+
+    const int cmp = bigFloat::s_compareMagnitudes(a, b);
+
+    return negativeA ? cmp > 0 : cmp < 0;
+}
+
+}  // namespace mandel::core
@@ -0,0 +1,458 @@
+#include "core/big_multiply.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace mandel::core {
+namespace {
+    void multiplySchoolbook(
+        const std::uint32_t* a,
+        const std::size_t sizeA,
+        const std::uint32_t* b,
+        const std::size_t sizeB,
+        std::uint32_t* product) {
+        std::fill_n(product, sizeA + sizeB, 0u);
+
+        for (std::size_t i = 0; i < sizeA; ++i) {
+            std::uint64_t carry = 0;
+
+            for (std::size_t j = 0; j < sizeB; ++j) {
+                carry += static_cast<std::uint64_t>(a[i]) * b[j]
+                    + product[i + j];
+                product[i + j] = static_cast<std::uint32_t>(carry);
+                carry >>= 32;
+            }
+
+            product[i + sizeB] = static_cast<std::uint32_t>(carry);
+        }
+    }
+
+    // sum = a + b, sum holds size + 1 limbs
+    void addLimbs(
+        const std::uint32_t* a,
+        const std::uint32_t* b,
+        const std::size_t size,
+        std::uint32_t* sum) {
+        std::uint64_t carry = 0;
+
+        for (std::size_t i = 0; i < size; ++i) {
+            carry += static_cast<std::uint64_t>(a[i]) + b[i];
+            sum[i] = static_cast<std::uint32_t>(carry);
+            carry >>= 32;
+        }
+
+        sum[size] = static_cast<std::uint32_t>(carry);
+    }
+
+    // a += b, the carry out of b runs on through a
+    void addInPlace(
+        std::uint32_t* a,
+        const std::size_t sizeA,
+        const std::uint32_t* b,
+        const std::size_t sizeB) {
+        std::uint64_t carry = 0;
+
+        for (std::size_t i = 0; i < sizeA && (i < sizeB || carry != 0); ++i) {
+            carry += static_cast<std::uint64_t>(a[i]) + (i < sizeB ? b[i] : 0);
+            a[i] = static_cast<std::uint32_t>(carry);
+            carry >>= 32;
+        }
+    }
+
+    // a -= b with a >= b
+    void subInPlace(
+        std::uint32_t* a,
+        const std::size_t sizeA,
+        const std::uint32_t* b,
+        const std::size_t sizeB) {
+        std::uint64_t borrow = 0;
+
+        for (std::size_t i = 0; i < sizeA && (i < sizeB || borrow != 0); ++i) {
+            const std::uint64_t sub = (i < sizeB ? b[i] : 0) + borrow;
+
+            borrow = a[i] < sub ? 1 : 0;
+            a[i] = static_cast<std::uint32_t>(
+                (static_cast<std::uint64_t>(a[i]) + (borrow << 32)) - sub);
+        }
+    }
+
+    // a0 b0 + ((a0 + a1) (b0 + b1) - a0 b0 - a1 b1) B + a1 b1 B^2 with
+    // both operands size limbs long, product holds 2 size limbs
+    void multiplyKaratsuba(
+        const std::uint32_t* a,
+        const std::uint32_t* b,
+        const std::size_t size,
+        std::uint32_t* product) {
+        if (size < karatsubaThreshold) {
+            multiplySchoolbook(a, size, b, size, product);
+            return;
+        }
+
+        const std::size_t low = size / 2;
+        const std::size_t high = size - low;
+
+        // a0 b0 and a1 b1 go straight into their place of the product
+        multiplyKaratsuba(a, b, low, product);
+        multiplyKaratsuba(a + low, b + low, high, product + 2 * low);
+
+        std::vector<std::uint32_t> sumA(high + 1), sumB(high + 1);
+        std::vector<std::uint32_t> middle(2 * (high + 1));
+
+        // the low halves are zero extended to the size of the high ones
+        std::vector<std::uint32_t> lowA(a, a + low), lowB(b, b + low);
+        lowA.resize(high, 0u);
+        lowB.resize(high, 0u);
+
+        addLimbs(lowA.data(), a + low, high, sumA.data());
+        addLimbs(lowB.data(), b + low, high, sumB.data());
+
+        multiplyKaratsuba(sumA.data(), sumB.data(), high + 1, middle.data());
+
+        subInPlace(middle.data(), middle.size(), product, 2 * low);
+        subInPlace(middle.data(), middle.size(), product + 2 * low, 2 * high);
+
+        addInPlace(product + low, 2 * size - low, middle.data(), middle.size());
+    }
+
+    // the two ntt primes, 2^k c + 1 with 3 as a primitive root, their
+    // product is above 2^58 which holds any convolution of 16 bit digits up
+    // to 2^23 digits long
+    constexpr std::uint32_t nttPrimes[2] = {998244353, 469762049};
+    constexpr std::uint32_t nttRoot = 3;
+    constexpr std::size_t maxNttLength = std::size_t(1) << 23;
+
+    // arithmetic modulo an odd prime below 2^30 in montgomery form, x is
+    // stored as x 2^32 mod prime so a product needs no division
+    class montgomery {
+      public:
+        explicit montgomery(const std::uint32_t prime) : m_prime(prime) {
+            // -prime^-1 mod 2^32 by newton iteration
+            std::uint32_t inverse = prime;
+            for (int i = 0; i < 4; ++i)
+                inverse *= 2u - prime * inverse;
+            m_negInverse = 0u - inverse;
+
+            m_r2 = static_cast<std::uint32_t>(
+                (std::uint64_t(1) << 63) % prime * 2 % prime);
+        }
+
+        [[nodiscard]] std::uint32_t prime() const noexcept {
+            return m_prime;
+        }
+
+        [[nodiscard]] std::uint32_t m_to(const std::uint32_t x) const {
+            return m_multiply(x, m_r2);
+        }
+
+        [[nodiscard]] std::uint32_t m_from(const std::uint32_t x) const {
+            return m_reduce(x);
+        }
+
+        [[nodiscard]] std::uint32_t
+        m_multiply(const std::uint32_t a, const std::uint32_t b) const {
+            return m_reduce(static_cast<std::uint64_t>(a) * b);
+        }
+
+        [[nodiscard]] std::uint32_t
+        m_add(const std::uint32_t a, const std::uint32_t b) const {
+            const std::uint32_t sum = a + b;
+            return sum >= m_prime ? sum - m_prime : sum;
+        }
+
+        [[nodiscard]] std::uint32_t
+        m_sub(const std::uint32_t a, const std::uint32_t b) const {
+            return a >= b ? a - b : a + m_prime - b;
+        }
+
+        // base^e of a value in montgomery form
+        [[nodiscard]] std::uint32_t
+        m_pow(std::uint32_t base, std::uint64_t e) const {
+            std::uint32_t result = m_to(1);
+
+            for (; e != 0; e >>= 1) {
+                if ((e & 1) != 0)
+                    result = m_multiply(result, base);
+                base = m_multiply(base, base);
+            }
+
+            return result;
+        }
+
+      private:
+        [[nodiscard]] std::uint32_t m_reduce(const std::uint64_t t) const {
+            const std::uint32_t m = static_cast<std::uint32_t>(t) * m_negInverse;
+            const std::uint32_t u = static_cast<std::uint32_t>(
+                (t + static_cast<std::uint64_t>(m) * m_prime) >> 32);
+
+            return u >= m_prime ? u - m_prime : u;
+        }
+
+        std::uint32_t m_prime;
+        std::uint32_t m_negInverse;
+        // 2^64 mod prime
+        std::uint32_t m_r2;
+    };
+
+    // roots[half + i] = w^i for i < half, w the primitive 2 half th root of
+    // unity or its inverse, for every power of two half below size
+    std::vector<std::uint32_t> rootTable(
+        const std::size_t size,
+        const montgomery& field,
+        const bool bInverse) {
+        const std::uint32_t prime = field.prime();
+
+        std::vector<std::uint32_t> roots(size);
+
+        for (std::size_t half = 1; half < size; half <<= 1) {
+            std::uint32_t step =
+                field.m_pow(field.m_to(nttRoot), (prime - 1) / (2 * half));
+
+            if (bInverse)
+                step = field.m_pow(step, prime - 2);
+
+            roots[half] = field.m_to(1);
+
+            for (std::size_t i = 1; i < half; ++i)
+                roots[half + i] = field.m_multiply(roots[half + i - 1], step);
+        }
+
+        return roots;
+    }
+
+    // decimation in frequency, leaves the transform in bit reversed order
+    // which is all the pointwise product needs
+    void forwardTransform(
+        std::vector<std::uint32_t>& values,
+        const std::vector<std::uint32_t>& roots,
+        const montgomery& field) {
+        const std::size_t size = values.size();
+
+        for (std::size_t half = size / 2; half >= 1; half >>= 1) {
+            const std::uint32_t* root = roots.data() + half;
+
+            for (std::size_t start = 0; start < size; start += 2 * half) {
+                std::uint32_t* low = values.data() + start;
+                std::uint32_t* high = low + half;
+
+                for (std::size_t i = 0; i < half; ++i) {
+                    const std::uint32_t u = low[i];
+                    const std::uint32_t v = high[i];
+
+                    low[i] = field.m_add(u, v);
+                    high[i] = field.m_multiply(field.m_sub(u, v), root[i]);
+                }
+            }
+        }
+    }
+
+    // decimation in time from bit reversed order back to natural order,
+    // roots are the inverse ones and the result is not divided by size yet
+    void inverseTransform(
+        std::vector<std::uint32_t>& values,
+        const std::vector<std::uint32_t>& roots,
+        const montgomery& field) {
+        const std::size_t size = values.size();
+
+        for (std::size_t half = 1; half < size; half <<= 1) {
+            const std::uint32_t* root = roots.data() + half;
+
+            for (std::size_t start = 0; start < size; start += 2 * half) {
+                std::uint32_t* low = values.data() + start;
+                std::uint32_t* high = low + half;
+
+                for (std::size_t i = 0; i < half; ++i) {
+                    const std::uint32_t u = low[i];
+                    const std::uint32_t v = field.m_multiply(high[i], root[i]);
+
+                    low[i] = field.m_add(u, v);
+                    high[i] = field.m_sub(u, v);
+                }
+            }
+        }
+    }
+
+    // cyclic convolution of the 16 bit digits of a and b modulo prime
+    std::vector<std::uint32_t> convolve(
+        const std::uint32_t* a,
+        const std::size_t sizeA,
+        const std::uint32_t* b,
+        const std::size_t sizeB,
+        const std::size_t length,
+        const std::uint32_t prime) {
+        const montgomery field(prime);
+
+        std::vector<std::uint32_t> digitsA(length, 0), digitsB(length, 0);
+
+        // digits below 2^16 are already reduced
+        for (std::size_t i = 0; i < sizeA; ++i) {
+            digitsA[2 * i] = field.m_to(a[i] & 0xffffu);
+            digitsA[2 * i + 1] = field.m_to(a[i] >> 16);
+        }
+
+        for (std::size_t i = 0; i < sizeB; ++i) {
+            digitsB[2 * i] = field.m_to(b[i] & 0xffffu);
+            digitsB[2 * i + 1] = field.m_to(b[i] >> 16);
+        }
+
+        const std::vector<std::uint32_t> roots =
+            rootTable(length, field, false);
+
+        forwardTransform(digitsA, roots, field);
+        forwardTransform(digitsB, roots, field);
+
+        // the division by length rides along with the pointwise product
+        const std::uint32_t invLength = field.m_pow(
+            field.m_to(static_cast<std::uint32_t>(length % prime)),
+            prime - 2);
+
+        for (std::size_t i = 0; i < length; ++i) {
+            digitsA[i] = field.m_multiply(
+                field.m_multiply(digitsA[i], digitsB[i]),
+                invLength);
+        }
+
+        inverseTransform(digitsA, rootTable(length, field, true), field);
+
+        for (std::uint32_t& v : digitsA)
+            v = field.m_from(v);
+
+        return digitsA;
+    }
+
+    void multiplyNtt(
+        const std::uint32_t* a,
+        const std::size_t sizeA,
+        const std::uint32_t* b,
+        const std::size_t sizeB,
+        std::uint32_t* product) {
+        const std::size_t digits = 2 * (sizeA + sizeB);
+
+        std::size_t length = 1;
+        while (length < digits)
+            length <<= 1;
+
+        if (length > maxNttLength) {
+            MultiplyLimbs(
+                multiplyAlgorithm::karatsuba,
+                a,
+                sizeA,
+                b,
+                sizeB,
+                product);
+            return;
+        }
+
+        const std::vector<std::uint32_t> lowResidues =
+            convolve(a, sizeA, b, sizeB, length, nttPrimes[0]);
+        const std::vector<std::uint32_t> highResidues =
+            convolve(a, sizeA, b, sizeB, length, nttPrimes[1]);
+
+        // chinese remaindering, x = r0 + p0 ((r1 - r0) / p0 mod p1)
+        const std::uint64_t p0 = nttPrimes[0];
+        const std::uint64_t p1 = nttPrimes[1];
+
+        const montgomery field(nttPrimes[1]);
+        const std::uint32_t invP0 = field.m_pow(
+            field.m_to(static_cast<std::uint32_t>(p0 % p1)),
+            p1 - 2);
+
+        std::uint64_t carry = 0;
+
+        for (std::size_t i = 0; i < sizeA + sizeB; ++i) {
+            std::uint32_t limb = 0;
+
+            for (std::size_t half = 0; half < 2; ++half) {
+                const std::size_t d = 2 * i + half;
+
+                const std::uint32_t r0 = lowResidues[d];
+                const std::uint32_t r1 = highResidues[d];
+
+                // (r1 - r0) invP0 in montgomery form comes out plain
+                const std::uint32_t t = field.m_multiply(
+                    field.m_sub(r1, static_cast<std::uint32_t>(r0 % p1)),
+                    invP0);
+
+                carry += r0 + p0 * t;
+
+                limb |= static_cast<std::uint32_t>(carry & 0xffffu)
+                    << (16 * half);
+                carry >>= 16;
+            }
+
+            product[i] = limb;
+        }
+    }
+}  // namespace
+
+multiplyAlgorithm GetMultiplyAlgorithm(
+    const std::size_t sizeA,
+    const std::size_t sizeB) {
+    const std::size_t size = std::min(sizeA, sizeB);
+
+    if (size >= nttThreshold)
+        return multiplyAlgorithm::ntt;
+    if (size >= karatsubaThreshold)
+        return multiplyAlgorithm::karatsuba;
+
+    return multiplyAlgorithm::schoolbook;
+}
+
+void MultiplyLimbs(
+    const std::uint32_t* a,
+    const std::size_t sizeA,
+    const std::uint32_t* b,
+    const std::size_t sizeB,
+    std::uint32_t* product) {
+    MultiplyLimbs(
+        GetMultiplyAlgorithm(sizeA, sizeB),
+        a,
+        sizeA,
+        b,
+        sizeB,
+        product);
+}
+
+void MultiplyLimbs(
+    const multiplyAlgorithm algorithm,
+    const std::uint32_t* a,
+    const std::size_t sizeA,
+    const std::uint32_t* b,
+    const std::size_t sizeB,
+    std::uint32_t* product) {
+    switch (algorithm) {
+        case multiplyAlgorithm::karatsuba: {
+            if (sizeA == sizeB) {
+                multiplyKaratsuba(a, b, sizeA, product);
+                return;
+            }
+
+            // the shorter operand is zero extended, the product of the
+            // padded operands is that many limbs longer
+            const std::size_t size = std::max(sizeA, sizeB);
+
+            std::vector<std::uint32_t> paddedA(a, a + sizeA);
+            std::vector<std::uint32_t> paddedB(b, b + sizeB);
+            std::vector<std::uint32_t> padded(2 * size);
+
+            paddedA.resize(size, 0u);
+            paddedB.resize(size, 0u);
+
+            multiplyKaratsuba(
+                paddedA.data(),
+                paddedB.data(),
+                size,
+                padded.data());
+
+            std::copy_n(padded.begin(), sizeA + sizeB, product);
+            return;
+        }
+        case multiplyAlgorithm::ntt:
+            multiplyNtt(a, sizeA, b, sizeB, product);
+            return;
+        default:
+            multiplySchoolbook(a, sizeA, b, sizeB, product);
+            return;
+    }
+}
+
+}  // namespace mandel::core
@@ -0,0 +1,91 @@
+#include "core/bla.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mandel::core {
+namespace {
+    // a step stays valid while the dropped delta^2 term is this much
+    // smaller than the linear part, 2^-32 keeps the error of the jumps
+    // below the one of plain perturbation on chaotic pixels
+    constexpr double blaEpsilon = 1.0 / 4294967296.0;
+
+    // the step of orbit index i, delta_(i + 1) = 2 Z_i delta_i + delta_c
+    blaStep getSingleStep(const referenceOrbit& orbit, const std::size_t i) {
+        const double zx = orbit.x[i];
+        const double zy = orbit.y[i];
+
+        // the last value of an orbit has no next one to step to
+        const bool bEnd = i == orbit.startEnd || i == orbit.rebaseEnd;
+
+        // the escape of a pixel is only checked between steps, so z must
+        // not be able to leave the radius 2 circle inside one either
+        const double z = std::hypot(zx, zy);
+        const double r = std::min(blaEpsilon * z, 2.0 - z);
+
+        return {2.0 * zx, 2.0 * zy, 1.0, 0.0, bEnd || r <= 0.0 ? -1.0 : r * r};
+    }
+
+    // step x followed by step y
+    blaStep mergeSteps(
+        const blaStep& x,
+        const blaStep& y,
+        const double maxDeltaC) {
+        blaStep result;
+
+        result.ax = y.ax * x.ax - y.ay * x.ay;
+        result.ay = y.ax * x.ay + y.ay * x.ax;
+        result.bx = y.ax * x.bx - y.ay * x.by + y.bx;
+        result.by = y.ax * x.by + y.ay * x.bx + y.by;
+
+        if (x.r2 < 0.0 || y.r2 < 0.0) {
+            result.r2 = -1.0;
+            return result;
+        }
+
+        // after x the delta is up to |a_x| r + |b_x| |delta_c| large, which
+        // has to stay inside the radius of y
+        const double ax = std::hypot(x.ax, x.ay);
+        const double bx = std::hypot(x.bx, x.by);
+
+        const double ry = ax > 0.0
+            ? std::max(0.0, (std::sqrt(y.r2) - bx * maxDeltaC) / ax)
+            : 0.0;
+
+        const double r = std::min(std::sqrt(x.r2), ry);
+        result.r2 = r * r;
+
+        return result;
+    }
+}  // namespace
+
+void ComputeBlaTable(
+    const referenceOrbit& orbit,
+    const double maxDeltaC,
+    blaTable& table) {
+    const std::size_t size = orbit.x.size();
+
+    table.levels.clear();
+
+    std::vector<blaStep> singleSteps(size);
+
+    for (std::size_t i = 0; i < size; ++i)
+        singleSteps[i] = getSingleStep(orbit, i);
+
+    // every level merges pairs of the one below
+    const std::vector<blaStep>* steps = &singleSteps;
+
+    for (std::size_t count = size / 2; count > 0; count /= 2) {
+        std::vector<blaStep> merged(count);
+
+        for (std::size_t j = 0; j < count; ++j) {
+            merged[j] =
+                mergeSteps((*steps)[2 * j], (*steps)[2 * j + 1], maxDeltaC);
+        }
+
+        table.levels.push_back(std::move(merged));
+        steps = &table.levels.back();
+    }
+}
+
+}  // namespace mandel::core
@@ -0,0 +1,114 @@
+#include "core/camera.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace mandel::core {
+namespace {
+    // increments below 2^-900 reach the view with a scale, the offsets of
+    // a frame several thousand pixels wide are still normal doubles then
+    constexpr std::int64_t minIncrementExponent = -900;
+}  // namespace
+
+camera::camera() {
+    m_reset({4.0, 4.0}, {640.0, 640.0});
+}
+
+void camera::m_reset(
+    const vec4<double> worldSpace,
+    const vec4<double> screenSize) {
+    m_position = {0.0, 0.0};
+    m_increment = std::max(
+        worldSpace.x / screenSize.x,
+        worldSpace.y / screenSize.y);
+
+    m_setAngle(0.0);
+    m_updatePrecision();
+}
+
+void camera::m_resize(
+    const vec4<double> oldScreenSize,
+    const vec4<double> newScreenSize) {
+    if (newScreenSize.x <= 0.0 || newScreenSize.y <= 0.0)
+        return;
+
+    m_increment *= std::max(
+        oldScreenSize.x / newScreenSize.x,
+        oldScreenSize.y / newScreenSize.y);
+
+    m_updatePrecision();
+}
+
+void camera::m_move(const vec4<double> movement) {
+    m_offset(m_getRotated(vec4<double>(0.0) - movement));
+}
+
+void camera::m_zoom(
+    const double zoomFactor,
+    const vec4<double> mousePos,
+    const vec4<double> screenSize) {
+    // the mouse world location moves by rotated(mouse - center) *
+    // increment * (zoomFactor - 1), take it back from the position
+    const vec4<double> fromCenter =
+        m_getRotated(mousePos - screenSize / vec4<double>(2.0));
+
+    m_offset(fromCenter * vec4<double>(1.0 - zoomFactor));
+
+    m_increment *= zoomFactor;
+
+    m_updatePrecision();
+}
+
+void camera::m_setAngle(const double angle) {
+    m_angle = angle;
+    m_rotation = {std::cos(angle), std::sin(angle)};
+}
+
+vec4<double> camera::m_getStartPos() const {
+    return {m_position.x.m_toDouble(), m_position.y.m_toDouble()};
+}
+
+double camera::m_getIncrement() const {
+    return m_increment.m_toDouble();
+}
+
+void camera::m_apply(view& v) const {
+    const std::int64_t exponent = m_increment.m_exponent();
+
+    v.startPos = m_position;
+    v.incrementScale = exponent < minIncrementExponent
+        ? static_cast<int>(exponent)
+        : 0;
+    v.increment = m_increment.m_ldexp(-v.incrementScale).m_toDouble();
+    v.rotation = m_rotation;
+}
+
+vec4<double> camera::m_getRotated(vec4<double> vec) const {
+    const double oldX = vec.x;
+
+    vec.x = vec.x * m_rotation.x - vec.y * m_rotation.y;
+    vec.y = oldX * m_rotation.y + vec.y * m_rotation.x;
+
+    return vec;
+}
+
+void camera::m_offset(const vec4<double> offset) {
+    const std::size_t precision = m_position.x.m_precision();
+
+    m_position.x += bigFloat(offset.x, precision) * m_increment;
+    m_position.y += bigFloat(offset.y, precision) * m_increment;
+}
+
+void camera::m_updatePrecision() {
+    // 64 bits under the pixel spacing
+    const std::int64_t bits = std::max<std::int64_t>(
+        64,
+        64 - m_increment.m_exponent()
+            + std::max(m_position.x.m_exponent(), m_position.y.m_exponent()));
+
+    m_position.x.m_setPrecision(static_cast<std::size_t>(bits));
+    m_position.y.m_setPrecision(static_cast<std::size_t>(bits));
+}
+
+}  // namespace mandel::core
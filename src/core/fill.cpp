@@ -0,0 +1,426 @@
+#include "core/fill.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace mandel::core {
+namespace {
+    // rectangles whose inside is at most this many pixels wide or high are
+    // computed in full, splitting them costs more than it saves
+    constexpr int minSubdivideSize = 4;
+
+    // the kernel and frame a FillRect runs on and what it did so far
+    struct fillContext {
+        const frameKernel& kernel;
+        const int width;
+        int* iterations;
+        std::vector<std::uint32_t>& pixels;
+        fillStats stats;
+
+        std::size_t m_index(const int x, const int y) const {
+            return static_cast<std::size_t>(y) * static_cast<std::size_t>(width)
+                + static_cast<std::size_t>(x);
+        }
+
+        void m_add(const int x, const int y) {
+            pixels.push_back(static_cast<std::uint32_t>(m_index(x, y)));
+        }
+
+        // runs the kernel for the pixels added since the last m_run
+        void m_run() {
+            if (pixels.empty())
+                return;
+
+            stats.computedPixels += pixels.size();
+            stats.periodicPixels +=
+                kernel.m_run(pixels.data(), pixels.size(), iterations);
+
+            pixels.clear();
+        }
+    };
+
+    void addInside(fillContext& context, const pixelRect& r) {
+        for (int y = r.y0; y < r.y1; ++y) {
+            for (int x = r.x0; x < r.x1; ++x)
+                context.m_add(x, y);
+        }
+    }
+
+    // whether the border of r has one iteration count, which is set to value
+    bool isUniformBorder(
+        const fillContext& context,
+        const pixelRect& r,
+        int& value) {
+        const int* iterations = context.iterations;
+
+        value = iterations[context.m_index(r.x0, r.y0)];
+
+        for (int x = r.x0; x < r.x1; ++x) {
+            if (iterations[context.m_index(x, r.y0)] != value
+                || iterations[context.m_index(x, r.y1 - 1)] != value)
+                return false;
+        }
+
+        for (int y = r.y0 + 1; y < r.y1 - 1; ++y) {
+            if (iterations[context.m_index(r.x0, y)] != value
+                || iterations[context.m_index(r.x1 - 1, y)] != value)
+                return false;
+        }
+
+        return true;
+    }
+
+    // rects holds rectangles whose border is computed, they are filled or
+    // split one level at a time so each level is a single kernel call that
+    // keeps the vector lanes busy
+    void subdivide(fillContext& context, std::vector<pixelRect> rects) {
+        std::vector<pixelRect> next;
+
+        while (!rects.empty()) {
+            next.clear();
+
+            for (const pixelRect& r : rects) {
+                const pixelRect inside {r.x0 + 1, r.y0 + 1, r.x1 - 1, r.y1 - 1};
+
+                const int insideWidth = inside.x1 - inside.x0;
+                const int insideHeight = inside.y1 - inside.y0;
+
+                if (insideWidth <= 0 || insideHeight <= 0)
+                    continue;
+
+                int value;
+
+                if (isUniformBorder(context, r, value)) {
+                    for (int y = inside.y0; y < inside.y1; ++y) {
+                        std::fill_n(
+                            context.iterations + context.m_index(inside.x0, y),
+                            insideWidth,
+                            value);
+                    }
+                    continue;
+                }
+
+                if (std::min(insideWidth, insideHeight) <= minSubdivideSize) {
+                    addInside(context, inside);
+                    continue;
+                }
+
+                // the line through the middle of the longer side becomes the
+                // shared border of both halves
+                if (insideWidth >= insideHeight) {
+                    const int middle = r.x0 + (r.x1 - r.x0) / 2;
+
+                    addInside(
+                        context,
+                        {middle, inside.y0, middle + 1, inside.y1});
+
+                    next.push_back({r.x0, r.y0, middle + 1, r.y1});
+                    next.push_back({middle, r.y0, r.x1, r.y1});
+                } else {
+                    const int middle = r.y0 + (r.y1 - r.y0) / 2;
+
+                    addInside(
+                        context,
+                        {inside.x0, middle, inside.x1, middle + 1});
+
+                    next.push_back({r.x0, r.y0, r.x1, middle + 1});
+                    next.push_back({r.x0, middle, r.x1, r.y1});
+                }
+            }
+
+            context.m_run();
+
+            std::swap(rects, next);
+        }
+    }
+
+    // per pixel progress of traceBoundaries, expanded pixels are computed
+    // and have had their neighbours queued, region pixels belong to a
+    // region of unseen pixels being looked at
+    enum class traceState : std::uint8_t {
+        unseen,
+        filled,
+        region,
+        queued,
+        computed,
+        expanded
+    };
+
+    struct pixelCoord {
+        int x, y;
+    };
+
+    // computes the border of r and then, one wave per kernel call, the
+    // neighbours of every computed pixel that differs from a computed
+    // neighbour
+    //
+    // a region of unseen pixels the waves leave is filled when every
+    // computed pixel around it has one escaped iteration count, or is
+    // inside the set and marked nan in kernelParams::zX as caught in a
+    // cycle, of any other region the edge is queued so the waves go on
+    // inside it, an island of another count inside an escaped band or a
+    // proven ring that touches no computed pixel is still missed
+    void traceBoundaries(fillContext& context, const pixelRect& r) {
+        const int w = r.x1 - r.x0;
+        const int h = r.y1 - r.y0;
+
+        // pixels of r are numbered row by row from its top left corner
+        const auto local = [w](const int x, const int y) {
+            return static_cast<std::size_t>(y * w + x);
+        };
+
+        const auto iterationsAt = [&](const int x, const int y) -> int& {
+            return context.iterations[context.m_index(r.x0 + x, r.y0 + y)];
+        };
+
+        const int maxIteration = context.kernel.params.maxIteration;
+        const double* zX = context.kernel.params.zX;
+
+        std::vector<traceState> state(local(0, h), traceState::unseen);
+        std::vector<pixelCoord> wave;
+        std::vector<pixelCoord> next;
+
+        const auto queue = [&](const int x, const int y) {
+            traceState& pixel = state[local(x, y)];
+
+            if (pixel != traceState::unseen)
+                return;
+
+            pixel = traceState::queued;
+            next.push_back({x, y});
+        };
+
+        const auto queueNeighbours = [&](const int x, const int y) {
+            traceState& pixel = state[local(x, y)];
+
+            if (pixel == traceState::expanded)
+                return;
+
+            pixel = traceState::expanded;
+
+            for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, h - 1);
+                 ++ny) {
+                for (int nx = std::max(x - 1, 0);
+                     nx <= std::min(x + 1, w - 1);
+                     ++nx)
+                    queue(nx, ny);
+            }
+        };
+
+        const auto runWaves = [&]() {
+            while (!next.empty()) {
+                std::swap(wave, next);
+                next.clear();
+
+                for (const pixelCoord& pixel : wave)
+                    context.m_add(r.x0 + pixel.x, r.y0 + pixel.y);
+
+                context.m_run();
+
+                for (const pixelCoord& pixel : wave)
+                    state[local(pixel.x, pixel.y)] = traceState::computed;
+
+                // a pixel computed before its neighbour could not compare
+                // to it yet, so a change queues the neighbours of both
+                // sides
+                for (const pixelCoord& pixel : wave) {
+                    const int own = iterationsAt(pixel.x, pixel.y);
+
+                    for (int ny = std::max(pixel.y - 1, 0);
+                         ny <= std::min(pixel.y + 1, h - 1);
+                         ++ny) {
+                        const int* row = &iterationsAt(0, ny);
+                        const traceState* rowState =
+                            state.data() + local(0, ny);
+
+                        for (int nx = std::max(pixel.x - 1, 0);
+                             nx <= std::min(pixel.x + 1, w - 1);
+                             ++nx) {
+                            if (rowState[nx] < traceState::computed
+                                || row[nx] == own)
+                                continue;
+
+                            queueNeighbours(pixel.x, pixel.y);
+                            queueNeighbours(nx, ny);
+                        }
+                    }
+                }
+            }
+        };
+
+        // the 4 connected unseen pixels around (x, y), value is the count
+        // of the computed pixels next to them when they all have one and
+        // bProven whether they are all caught in a cycle
+        std::vector<pixelCoord> region;
+        // pixels of regions whose edge was queued, unseen again once every
+        // region was looked at
+        std::vector<pixelCoord> deferred;
+
+        const auto findRegion =
+            [&](const int x, const int y, int& value, bool& bProven) {
+            const pixelCoord steps[] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+            bool bValue = false;
+            bool bUniform = true;
+
+            bProven = zX != nullptr;
+
+            region.clear();
+            region.push_back({x, y});
+            state[local(x, y)] = traceState::region;
+
+            for (std::size_t i = 0; i < region.size(); ++i) {
+                const pixelCoord pixel = region[i];
+
+                for (const pixelCoord& step : steps) {
+                    const int nx = pixel.x + step.x;
+                    const int ny = pixel.y + step.y;
+
+                    if (nx < 0 || nx >= w || ny < 0 || ny >= h)
+                        continue;
+
+                    traceState& neighbour = state[local(nx, ny)];
+
+                    if (neighbour == traceState::unseen) {
+                        neighbour = traceState::region;
+                        region.push_back({nx, ny});
+                    } else if (neighbour >= traceState::computed) {
+                        const int count = iterationsAt(nx, ny);
+
+                        bUniform = bUniform && (!bValue || count == value);
+                        bProven = bProven
+                            && std::isnan(zX[context.m_index(
+                                r.x0 + nx,
+                                r.y0 + ny)]);
+                        bValue = true;
+                        value = count;
+                    }
+                }
+            }
+
+            return bUniform;
+        };
+
+        const auto hasComputedNeighbour = [&](const pixelCoord& pixel) {
+            return (pixel.x > 0
+                    && state[local(pixel.x - 1, pixel.y)]
+                        >= traceState::computed)
+                || (pixel.x < w - 1
+                    && state[local(pixel.x + 1, pixel.y)]
+                        >= traceState::computed)
+                || (pixel.y > 0
+                    && state[local(pixel.x, pixel.y - 1)]
+                        >= traceState::computed)
+                || (pixel.y < h - 1
+                    && state[local(pixel.x, pixel.y + 1)]
+                        >= traceState::computed);
+        };
+
+        for (int x = 0; x < w; ++x) {
+            queue(x, 0);
+            queue(x, h - 1);
+        }
+
+        for (int y = 1; y < h - 1; ++y) {
+            queue(0, y);
+            queue(w - 1, y);
+        }
+
+        // the border is computed, so every region has computed pixels
+        // next to it
+        do {
+            runWaves();
+
+            for (int y = 1; y < h - 1; ++y) {
+                for (int x = 1; x < w - 1; ++x) {
+                    if (state[local(x, y)] != traceState::unseen)
+                        continue;
+
+                    int value = 0;
+                    bool bProven = false;
+                    const bool bUniform = findRegion(x, y, value, bProven);
+
+                    if (bUniform && (value != maxIteration || bProven)) {
+                        for (const pixelCoord& pixel : region) {
+                            iterationsAt(pixel.x, pixel.y) = value;
+                            state[local(pixel.x, pixel.y)] =
+                                traceState::filled;
+                        }
+                        continue;
+                    }
+
+                    // points that escape through filaments thinner than a
+                    // pixel show up as lone pixels inside the set, so a
+                    // region inside it is peeled a ring at a time until
+                    // the ring around it is proven
+                    for (const pixelCoord& pixel : region) {
+                        if (hasComputedNeighbour(pixel)) {
+                            state[local(pixel.x, pixel.y)] =
+                                traceState::queued;
+                            next.push_back(pixel);
+                        } else {
+                            deferred.push_back(pixel);
+                        }
+                    }
+                }
+            }
+
+            for (const pixelCoord& pixel : deferred)
+                state[local(pixel.x, pixel.y)] = traceState::unseen;
+
+            deferred.clear();
+        } while (!next.empty());
+    }
+}  // namespace
+
+fillStats FillRect(
+    const frameKernel& kernel,
+    const fillMode mode,
+    const int width,
+    const pixelRect& rect,
+    int* iterations,
+    std::vector<std::uint32_t>& pixels) {
+    fillContext context {kernel, width, iterations, pixels, {}};
+
+    pixels.clear();
+
+    if (rect.x1 <= rect.x0 || rect.y1 <= rect.y0)
+        return context.stats;
+
+    if (mode == fillMode::everyPixel) {
+        addInside(context, rect);
+        context.m_run();
+
+        return context.stats;
+    }
+
+    if (mode == fillMode::boundaryTrace) {
+        traceBoundaries(context, rect);
+
+        return context.stats;
+    }
+
+    // the border first, in one kernel call
+    for (int x = rect.x0; x < rect.x1; ++x) {
+        context.m_add(x, rect.y0);
+
+        if (rect.y1 - 1 > rect.y0)
+            context.m_add(x, rect.y1 - 1);
+    }
+
+    for (int y = rect.y0 + 1; y < rect.y1 - 1; ++y) {
+        context.m_add(rect.x0, y);
+
+        if (rect.x1 - 1 > rect.x0)
+            context.m_add(rect.x1 - 1, y);
+    }
+
+    context.m_run();
+
+    subdivide(context, {rect});
+
+    return context.stats;
+}
+
+}  // namespace mandel::core
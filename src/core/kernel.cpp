@@ -0,0 +1,197 @@
+#include "core/kernel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <immintrin.h>
+    #include <intrin.h>
+#endif
+
+namespace mandel::core {
+namespace {
+    // periodicityTolerance in pixel spacings, an orbit that comes back this
+    // close to itself is far closer to its cycle than a pixel is wide
+    constexpr double periodicityScale = 1.0 / 1024.0;
+
+    // frames count their pixels from the corner of the lattice block of
+    // 2^blockBits pixels they start in, close enough that the offset of a
+    // pixel from it keeps the precision of a double
+    constexpr int blockBits = 16;
+
+    // the lattice has 2^fractionBits points per pixel, a frame moved by
+    // whole pixels is off them by far less than that
+    constexpr int fractionBits = 10;
+
+    // splits place, in pixels along a rotated axis from the origin of the
+    // plane, into the corner of its block and the pixels from there to the
+    // nearest point of the lattice
+    void splitPlace(const bigFloat& place, bigFloat& corner, double& pixels) {
+        const bigFloat half(0.5, place.m_precision());
+
+        const bigFloat point =
+            (place.m_ldexp(fractionBits) + half).m_floor().m_ldexp(
+                -fractionBits);
+
+        corner = point.m_ldexp(-blockBits).m_floor().m_ldexp(blockBits);
+        pixels = (point - corner).m_toDouble();
+    }
+
+    struct cpuFeatures {
+        bool avx2 = false;
+        bool avx512 = false;
+    };
+
+    cpuFeatures getCpuFeatures() {
+        cpuFeatures result;
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        // also checks that the os saves the wide registers
+        __builtin_cpu_init();
+
+        result.avx2 =
+            __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        result.avx512 = result.avx2 && __builtin_cpu_supports("avx512f");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        int info[4];
+
+        __cpuid(info, 1);
+
+        const bool fma = (info[2] & (1 << 12)) != 0;
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+
+        if (!osxsave)
+            return result;
+
+        // ymm and zmm state enabled by the os
+        const unsigned long long xcr0 = _xgetbv(0);
+        const bool osAvx = (xcr0 & 0x6) == 0x6;
+        const bool osAvx512 = (xcr0 & 0xe6) == 0xe6;
+
+        __cpuidex(info, 7, 0);
+
+        result.avx2 = osAvx && fma && (info[1] & (1 << 5)) != 0;
+        result.avx512 = result.avx2 && osAvx512 && (info[1] & (1 << 16)) != 0;
+#endif
+
+        return result;
+    }
+}  // namespace
+
+kernelParams GetKernelParams(
+    const view& v,
+    const int width,
+    const int height,
+    const bigVec2* reference) {
+    const double cosA = v.rotation.x;
+    const double sinA = v.rotation.y;
+
+    kernelParams p;
+
+    p.stepXx = v.increment.x * cosA;
+    p.stepXy = v.increment.x * sinA;
+    p.stepYx = -v.increment.y * sinA;
+    p.stepYy = v.increment.y * cosA;
+
+    // room for the whole pixels from the origin of the plane to the frame
+    // and the lattice below them
+    const std::size_t bits =
+        std::max(v.startPos.x.m_precision(), v.startPos.y.m_precision())
+        + 128;
+
+    const bigFloat centerX = v.startPos.x.m_ldexp(-v.incrementScale);
+    const bigFloat centerY = v.startPos.y.m_ldexp(-v.incrementScale);
+    const bigFloat cos(cosA, bits);
+    const bigFloat sin(sinA, bits);
+
+    // the first pixel along the rotated axes, the offset is the same as
+    // gl_FragCoord.xy - u_vScreenSize / 2 for it
+    const bigFloat firstX = (centerX * cos + centerY * sin)
+            * bigFloat(1.0 / v.increment.x, bits)
+        + bigFloat(0.5 - width / 2, bits);
+    const bigFloat firstY = (centerY * cos - centerX * sin)
+            * bigFloat(1.0 / v.increment.y, bits)
+        + bigFloat(0.5 - height / 2, bits);
+
+    bigFloat cornerX, cornerY;
+    splitPlace(firstX, cornerX, p.pixelX);
+    splitPlace(firstY, cornerY, p.pixelY);
+
+    // the corner in units of the increment scale, a reference is
+    // subtracted in full precision so next to it the origin is a small
+    // exact double, the origin keeps a second double of what did not fit
+    // into the first
+    bigFloat originX =
+        cornerX * bigFloat(p.stepXx, bits) + cornerY * bigFloat(p.stepYx, bits);
+    bigFloat originY =
+        cornerX * bigFloat(p.stepXy, bits) + cornerY * bigFloat(p.stepYy, bits);
+
+    if (reference != nullptr) {
+        originX -= reference->x.m_ldexp(-v.incrementScale);
+        originY -= reference->y.m_ldexp(-v.incrementScale);
+    }
+
+    p.originX = originX.m_toDouble();
+    p.originY = originY.m_toDouble();
+    p.originXLo = (originX - bigFloat(p.originX, bits)).m_toDouble();
+    p.originYLo = (originY - bigFloat(p.originY, bits)).m_toDouble();
+
+    p.width = width;
+    p.maxIteration = v.maxIteration;
+
+    p.bUseJuliaSet = v.bUseJuliaSet;
+    p.juliaX = v.juliaConstant.x;
+    p.juliaY = v.juliaConstant.y;
+
+    p.exponent = v.exponent;
+
+    p.deltaScale = v.incrementScale;
+
+    p.periodicityTolerance = periodicityScale
+        * std::ldexp(
+            std::min(v.increment.x, v.increment.y),
+            v.incrementScale);
+
+    return p;
+}
+
+std::size_t GetExponentClass(const double exponent) {
+    if (exponent != std::floor(exponent)
+        || exponent < static_cast<double>(minIntegerExponent)
+        || exponent > static_cast<double>(maxIntegerExponent))
+        return polarExponentClass;
+
+    return static_cast<std::size_t>(
+        static_cast<int>(exponent) - minIntegerExponent);
+}
+
+const kernelTable* GetKernels(const isa set) {
+    static const cpuFeatures features = getCpuFeatures();
+
+    switch (set) {
+        case isa::scalar:
+            return GetScalarKernels();
+        case isa::avx2:
+            return features.avx2 ? GetAvx2Kernels() : nullptr;
+        case isa::avx512:
+            return features.avx512 ? GetAvx512Kernels() : nullptr;
+        default:
+            return nullptr;
+    }
+}
+
+const kernelTable& GetKernels() {
+    static const kernelTable& kernels = []() -> const kernelTable& {
+        for (const isa set : {isa::avx512, isa::avx2}) {
+            if (const kernelTable* table = GetKernels(set))
+                return *table;
+        }
+
+        return *GetScalarKernels();
+    }();
+
+    return kernels;
+}
+
+}  // namespace mandel::core
@@ -0,0 +1,22 @@
+#include "core/kernel.hpp"
+
+// compiled with -mavx2 -mfma, the whole unit is empty when the compiler can
+// not target it
+#if defined(__AVX2__)
+    #define MANDEL_KERNEL_ISA avx2
+    #include "core/kernel_impl.hpp"
+#endif
+
+namespace mandel::core {
+
+const kernelTable* GetAvx2Kernels() {
+#if defined(__AVX2__)
+    static const kernelTable table =
+        avx2::MakeKernelTable(isa::avx2, "avx2");
+    return &table;
+#else
+    return nullptr;
+#endif
+}
+
+}  // namespace mandel::core
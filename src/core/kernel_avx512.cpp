@@ -0,0 +1,22 @@
+#include "core/kernel.hpp"
+
+// compiled with -mavx512f, the whole unit is empty when the compiler can
+// not target it
+#if defined(__AVX512F__)
+    #define MANDEL_KERNEL_ISA avx512
+    #include "core/kernel_impl.hpp"
+#endif
+
+namespace mandel::core {
+
+const kernelTable* GetAvx512Kernels() {
+#if defined(__AVX512F__)
+    static const kernelTable table =
+        avx512::MakeKernelTable(isa::avx512, "avx512");
+    return &table;
+#else
+    return nullptr;
+#endif
+}
+
+}  // namespace mandel::core
@@ -0,0 +1,12 @@
+#define MANDEL_KERNEL_ISA scalar
+#include "core/kernel_impl.hpp"
+
+namespace mandel::core {
+
+const kernelTable* GetScalarKernels() {
+    static const kernelTable table =
+        scalar::MakeKernelTable(isa::scalar, "scalar");
+    return &table;
+}
+
+}  // namespace mandel::core
@@ -0,0 +1,541 @@
+#include "core/orbit_cache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mandel::core {
+namespace {
+    constexpr char fileMagic[8] = {'M', 'A', 'N', 'D', 'O', 'R', 'B', '1'};
+
+    // orbits GetReferenceOrbit keeps waiting for the writer, a long orbit
+    // is many megabytes and a lost one only costs a later frame its load
+    constexpr std::size_t maxPendingWrites = 4;
+
+    // the key, the x and the y values follow it, the key is padded to 8
+    // bytes
+    struct fileHeader {
+        char magic[8];
+        std::uint64_t keySize;
+        std::uint64_t precision;
+        std::uint64_t count;
+        std::uint64_t startIndex;
+        std::uint64_t startEnd;
+        std::uint64_t rebaseIndex;
+        std::uint64_t rebaseEnd;
+    };
+
+    // a whole file mapped read only, empty when it cannot be opened
+    class mappedFile {
+      public:
+        explicit mappedFile(const std::filesystem::path& path) {
+#ifdef _WIN32
+            const HANDLE file = CreateFileW(
+                path.c_str(),
+                GENERIC_READ,
+                FILE_SHARE_READ | FILE_SHARE_DELETE,
+                nullptr,
+                OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL,
+                nullptr);
+
+            if (file == INVALID_HANDLE_VALUE)
+                return;
+
+            LARGE_INTEGER size;
+
+            if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+                const HANDLE mapping = CreateFileMappingW(
+                    file,
+                    nullptr,
+                    PAGE_READONLY,
+                    0,
+                    0,
+                    nullptr);
+
+                if (mapping != nullptr) {
+                    m_data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                    CloseHandle(mapping);
+                }
+
+                if (m_data != nullptr)
+                    m_size = static_cast<std::size_t>(size.QuadPart);
+            }
+
+            CloseHandle(file);
+#else
+            const int file = open(path.c_str(), O_RDONLY);
+
+            if (file < 0)
+                return;
+
+            struct stat status;
+
+            if (fstat(file, &status) == 0 && status.st_size > 0) {
+                void* data = mmap(
+                    nullptr,
+                    static_cast<std::size_t>(status.st_size),
+                    PROT_READ,
+                    MAP_PRIVATE,
+                    file,
+                    0);
+
+                if (data != MAP_FAILED) {
+                    m_data = data;
+                    m_size = static_cast<std::size_t>(status.st_size);
+                }
+            }
+
+            close(file);
+#endif
+        }
+
+        mappedFile(const mappedFile&) = delete;
+        mappedFile& operator=(const mappedFile&) = delete;
+
+        ~mappedFile() {
+            if (m_data == nullptr)
+                return;
+
+#ifdef _WIN32
+            UnmapViewOfFile(m_data);
+#else
+            munmap(m_data, m_size);
+#endif
+        }
+
+        [[nodiscard]] const unsigned char* data() const noexcept {
+            return static_cast<const unsigned char*>(m_data);
+        }
+        [[nodiscard]] std::size_t size() const noexcept {
+            return m_size;
+        }
+
+      private:
+        void* m_data = nullptr;
+        std::size_t m_size = 0;
+    };
+
+    void appendBytes(
+        std::vector<unsigned char>& bytes,
+        const void* data,
+        const std::size_t size) {
+        const std::size_t offset = bytes.size();
+
+        bytes.resize(offset + size);
+
+        if (size != 0)
+            std::memcpy(bytes.data() + offset, data, size);
+    }
+
+    // the value of v, trailing zero limbs do not change it
+    void appendBigFloat(std::vector<unsigned char>& bytes, const bigFloat& v) {
+        const std::vector<std::uint32_t>& limbs = v.limbs();
+
+        std::size_t first = 0;
+        while (!v.m_isZero() && first < limbs.size() && limbs[first] == 0)
+            ++first;
+
+        const std::uint8_t sign = v.m_isZero() ? 0 : v.m_isNegative() ? 2 : 1;
+        const std::int64_t exponent = v.m_exponent();
+        const std::uint64_t size = v.m_isZero() ? 0 : limbs.size() - first;
+
+        appendBytes(bytes, &sign, sizeof(sign));
+        appendBytes(bytes, &exponent, sizeof(exponent));
+        appendBytes(bytes, &size, sizeof(size));
+        appendBytes(bytes, limbs.data() + first, size * sizeof(std::uint32_t));
+    }
+
+    // everything but the precision an orbit depends on
+    std::vector<unsigned char> getKey(const view& v, const bigVec2& center) {
+        std::vector<unsigned char> key;
+
+        const std::uint8_t bJulia = v.bUseJuliaSet ? 1 : 0;
+        const std::int32_t maxIteration = v.maxIteration;
+        const double julia[2] = {
+            v.bUseJuliaSet ? v.juliaConstant.x : 0.0,
+            v.bUseJuliaSet ? v.juliaConstant.y : 0.0};
+
+        appendBytes(key, &bJulia, sizeof(bJulia));
+        appendBytes(key, &maxIteration, sizeof(maxIteration));
+        appendBytes(key, julia, sizeof(julia));
+        appendBigFloat(key, center.x);
+        appendBigFloat(key, center.y);
+
+        return key;
+    }
+
+    std::uint64_t getPaddedSize(const std::uint64_t size) {
+        return (size + 7) / 8 * 8;
+    }
+
+    // 64 bit fnv-1a hash of the key as the file name
+    std::filesystem::path getFilePath(
+        const std::string& directory,
+        const std::vector<unsigned char>& key) {
+        std::uint64_t hash = 14695981039346656037ull;
+
+        for (const unsigned char byte : key) {
+            hash ^= byte;
+            hash *= 1099511628211ull;
+        }
+
+        char name[32];
+        std::snprintf(
+            name,
+            sizeof(name),
+            "%016llx.orbit",
+            static_cast<unsigned long long>(hash));
+
+        return std::filesystem::path(directory) / name;
+    }
+
+    // whether file holds an orbit of key, header is read from it
+    bool readHeader(
+        const mappedFile& file,
+        const std::vector<unsigned char>& key,
+        fileHeader& header) {
+        if (file.size() < sizeof(header))
+            return false;
+
+        std::memcpy(&header, file.data(), sizeof(header));
+
+        if (std::memcmp(header.magic, fileMagic, sizeof(fileMagic)) != 0
+            || header.keySize != key.size()
+            || file.size() < sizeof(header) + key.size()
+            || std::memcmp(file.data() + sizeof(header), key.data(), key.size())
+                != 0)
+            return false;
+
+        const std::uint64_t valueSize = 2 * header.count * sizeof(double);
+
+        if (header.count > file.size() / (2 * sizeof(double))
+            || file.size()
+                != sizeof(header) + getPaddedSize(key.size()) + valueSize)
+            return false;
+
+        // the kernels index the orbit with these without a check
+        return header.startIndex <= header.startEnd
+            && header.startEnd < header.count
+            && header.rebaseIndex <= header.rebaseEnd
+            && header.rebaseEnd < header.count;
+    }
+
+    // removes the least recently written or read orbit files of directory
+    // until the others take at most budget bytes
+    void evictOrbits(const std::string& directory, const std::size_t budget) {
+        struct orbitFile {
+            std::filesystem::file_time_type time;
+            std::uintmax_t size;
+            std::filesystem::path path;
+        };
+
+        std::vector<orbitFile> files;
+        std::uintmax_t total = 0;
+
+        std::error_code error;
+        std::filesystem::directory_iterator it(directory, error);
+
+        for (; !error && it != std::filesystem::directory_iterator();
+             it.increment(error)) {
+            if (it->path().extension() != ".orbit")
+                continue;
+
+            std::error_code fileError;
+            const std::uintmax_t size = it->file_size(fileError);
+            const auto time = it->last_write_time(fileError);
+
+            if (fileError)
+                continue;
+
+            files.push_back({time, size, it->path()});
+            total += size;
+        }
+
+        if (total <= budget)
+            return;
+
+        std::sort(
+            files.begin(),
+            files.end(),
+            [](const orbitFile& a, const orbitFile& b) {
+                return a.time < b.time;
+            });
+
+        for (const orbitFile& file : files) {
+            if (total <= budget)
+                break;
+
+            if (std::filesystem::remove(file.path, error))
+                total -= file.size;
+        }
+    }
+
+    // the thread StoreReferenceOrbit runs on for GetReferenceOrbit, it
+    // writes what is queued before the program exits
+    class orbitWriter {
+      public:
+        orbitWriter() : m_thread([this] { m_run(); }) {}
+
+        orbitWriter(const orbitWriter&) = delete;
+        orbitWriter& operator=(const orbitWriter&) = delete;
+
+        ~orbitWriter() {
+            {
+                const std::lock_guard<std::mutex> lock(m_mutex);
+                m_bStop = true;
+            }
+
+            m_wake.notify_one();
+            m_thread.join();
+        }
+
+        // copies orbit, drops it when maxPendingWrites are waiting
+        void m_queue(
+            const std::string& directory,
+            const std::size_t budget,
+            const referenceOrbit& orbit) {
+            {
+                const std::lock_guard<std::mutex> lock(m_mutex);
+
+                if (m_pending.size() >= maxPendingWrites)
+                    return;
+
+                m_pending.push_back({directory, budget, orbit});
+            }
+
+            m_wake.notify_one();
+        }
+
+      private:
+        struct pendingWrite {
+            std::string directory;
+            std::size_t budget;
+            referenceOrbit orbit;
+        };
+
+        void m_run() {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            for (;;) {
+                m_wake.wait(lock, [this] {
+                    return m_bStop || !m_pending.empty();
+                });
+
+                if (m_pending.empty())
+                    return;
+
+                const pendingWrite write = std::move(m_pending.front());
+                m_pending.pop_front();
+
+                lock.unlock();
+                StoreReferenceOrbit(write.directory, write.budget, write.orbit);
+                lock.lock();
+            }
+        }
+
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::deque<pendingWrite> m_pending;
+        bool m_bStop = false;
+
+        // last, it starts running in the constructor
+        std::thread m_thread;
+    };
+
+    orbitWriter& getOrbitWriter() {
+        static orbitWriter writer;
+        return writer;
+    }
+}  // namespace
+
+bool LoadReferenceOrbit(
+    const std::string& directory,
+    const view& v,
+    const bigVec2& center,
+    referenceOrbit& orbit) {
+    const std::vector<unsigned char> key = getKey(v, center);
+    const std::filesystem::path path = getFilePath(directory, key);
+
+    fileHeader header;
+
+    {
+        const mappedFile file(path);
+
+        if (!readHeader(file, key, header)
+            || header.precision < GetReferencePrecision(v))
+            return false;
+
+        const std::size_t count = header.count;
+        const unsigned char* values =
+            file.data() + sizeof(header) + getPaddedSize(key.size());
+
+        orbit.x.resize(count);
+        orbit.y.resize(count);
+
+        std::memcpy(orbit.x.data(), values, count * sizeof(double));
+        std::memcpy(
+            orbit.y.data(),
+            values + count * sizeof(double),
+            count * sizeof(double));
+    }
+
+    // the write time orders the files for evictOrbits
+    std::error_code error;
+    std::filesystem::last_write_time(
+        path,
+        std::filesystem::file_time_type::clock::now(),
+        error);
+
+    orbit.startIndex = header.startIndex;
+    orbit.startEnd = header.startEnd;
+    orbit.rebaseIndex = header.rebaseIndex;
+    orbit.rebaseEnd = header.rebaseEnd;
+
+    orbit.center = center;
+    orbit.precision = header.precision;
+    orbit.maxIteration = v.maxIteration;
+    orbit.bUseJuliaSet = v.bUseJuliaSet;
+    orbit.juliaConstant = v.juliaConstant;
+
+    return true;
+}
+
+void StoreReferenceOrbit(
+    const std::string& directory,
+    const std::size_t budget,
+    const referenceOrbit& orbit) {
+    view v;
+    v.maxIteration = orbit.maxIteration;
+    v.bUseJuliaSet = orbit.bUseJuliaSet;
+    v.juliaConstant = orbit.juliaConstant;
+
+    const std::vector<unsigned char> key = getKey(v, orbit.center);
+    const std::filesystem::path path = getFilePath(directory, key);
+
+    const std::uint64_t fileSize = sizeof(fileHeader)
+        + getPaddedSize(key.size()) + 2 * orbit.x.size() * sizeof(double);
+
+    if (fileSize > budget)
+        return;
+
+    {
+        const mappedFile file(path);
+        fileHeader header;
+
+        if (readHeader(file, key, header)
+            && header.precision >= orbit.precision)
+            return;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    if (error)
+        return;
+
+    // a name of its own for every writer, the rename replaces the file
+    // in one step
+    const std::size_t writer =
+        std::hash<std::thread::id>()(std::this_thread::get_id())
+        ^ static_cast<std::size_t>(
+            std::chrono::steady_clock::now().time_since_epoch().count());
+
+    std::filesystem::path temporary = path;
+    temporary += "." + std::to_string(writer) + ".tmp";
+
+    fileHeader header {};
+    std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.keySize = key.size();
+    header.precision = orbit.precision;
+    header.count = orbit.x.size();
+    header.startIndex = orbit.startIndex;
+    header.startEnd = orbit.startEnd;
+    header.rebaseIndex = orbit.rebaseIndex;
+    header.rebaseEnd = orbit.rebaseEnd;
+
+    const char padding[8] = {};
+
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(
+            reinterpret_cast<const char*>(key.data()),
+            static_cast<std::streamsize>(key.size()));
+        out.write(
+            padding,
+            static_cast<std::streamsize>(
+                getPaddedSize(key.size()) - key.size()));
+        out.write(
+            reinterpret_cast<const char*>(orbit.x.data()),
+            static_cast<std::streamsize>(orbit.x.size() * sizeof(double)));
+        out.write(
+            reinterpret_cast<const char*>(orbit.y.data()),
+            static_cast<std::streamsize>(orbit.y.size() * sizeof(double)));
+
+        out.close();
+
+        if (!out) {
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+
+    std::filesystem::rename(temporary, path, error);
+
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return;
+    }
+
+    evictOrbits(directory, budget);
+}
+
+orbitSource GetReferenceOrbit(
+    const view& v,
+    const bigVec2& center,
+    const std::string& directory,
+    const std::size_t budget,
+    referenceOrbit& orbit) {
+    if (IsReferenceOrbitOf(v, center, orbit))
+        return orbitSource::reused;
+
+    if (!directory.empty()
+        && LoadReferenceOrbit(directory, v, center, orbit))
+        return orbitSource::loaded;
+
+    ComputeReferenceOrbit(v, center, orbit);
+
+    if (!directory.empty())
+        getOrbitWriter().m_queue(directory, budget, orbit);
+
+    return orbitSource::computed;
+}
+
+}  // namespace mandel::core
@@ -0,0 +1,107 @@
+#include "core/reference_orbit.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mandel::core {
+namespace {
+    // appends z_(n + 1) = z_n^2 + c from z until it escapes or maxIteration
+    // more values are stored, returns the index of the last one
+    std::size_t appendOrbit(
+        bigFloat x,
+        bigFloat y,
+        const bigVec2& c,
+        const std::size_t maxCount,
+        referenceOrbit& orbit) {
+        for (std::size_t i = 0;; ++i) {
+            const double dx = x.m_toDouble();
+            const double dy = y.m_toDouble();
+
+            orbit.x.push_back(dx);
+            orbit.y.push_back(dy);
+
+            if (i + 1 >= maxCount || dx * dx + dy * dy > 4.0)
+                break;
+
+            const bigFloat x2 = x * x;
+            const bigFloat y2 = y * y;
+
+            y = (x * y).m_ldexp(1) + c.y;
+            x = x2 - y2 + c.x;
+        }
+
+        return orbit.x.size() - 1;
+    }
+}  // namespace
+
+std::size_t GetReferencePrecision(const view& v) {
+    const double increment =
+        std::min(std::fabs(v.increment.x), std::fabs(v.increment.y));
+
+    const int exp =
+        (increment > 0.0 ? std::ilogb(increment) : 0) + v.incrementScale;
+
+    return static_cast<std::size_t>(std::max(64, 64 - exp));
+}
+
+bool IsReferenceOrbitOf(
+    const view& v,
+    const bigVec2& center,
+    const referenceOrbit& orbit) {
+    if (orbit.x.empty() || orbit.maxIteration != v.maxIteration
+        || orbit.bUseJuliaSet != v.bUseJuliaSet)
+        return false;
+
+    if (v.bUseJuliaSet
+        && (orbit.juliaConstant.x != v.juliaConstant.x
+            || orbit.juliaConstant.y != v.juliaConstant.y))
+        return false;
+
+    return orbit.precision >= GetReferencePrecision(v)
+        && orbit.center.x == center.x && orbit.center.y == center.y;
+}
+
+void ComputeReferenceOrbit(
+    const view& v,
+    const bigVec2& center,
+    referenceOrbit& orbit) {
+    const std::size_t precision = GetReferencePrecision(v);
+    const std::size_t maxIteration =
+        static_cast<std::size_t>(std::max(v.maxIteration, 0));
+
+    bigVec2 c = center;
+    c.x.m_setPrecision(precision);
+    c.y.m_setPrecision(precision);
+
+    orbit.x.clear();
+    orbit.y.clear();
+    orbit.center = center;
+    orbit.precision = c.x.m_precision();
+    orbit.maxIteration = v.maxIteration;
+    orbit.bUseJuliaSet = v.bUseJuliaSet;
+    orbit.juliaConstant = v.juliaConstant;
+
+    const bigFloat zero(0.0, precision);
+
+    if (!v.bUseJuliaSet) {
+        // z_0 = 0, the first iteration of a pixel is z_1 = c
+        orbit.startIndex = 1;
+        orbit.startEnd = appendOrbit(zero, zero, c, maxIteration + 2, orbit);
+        orbit.rebaseIndex = 0;
+        orbit.rebaseEnd = orbit.startEnd;
+    } else {
+        const bigVec2 julia {
+            bigFloat(v.juliaConstant.x, precision),
+            bigFloat(v.juliaConstant.y, precision)};
+
+        orbit.startIndex = 0;
+        orbit.startEnd = appendOrbit(c.x, c.y, julia, maxIteration + 1, orbit);
+
+        // the critical point
+        orbit.rebaseIndex = orbit.x.size();
+        orbit.rebaseEnd =
+            appendOrbit(zero, zero, julia, maxIteration + 1, orbit);
+    }
+}
+
+}  // namespace mandel::core
@@ -0,0 +1,506 @@
+#include "core/render.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "core/fill.hpp"
+#include "core/kernel.hpp"
+#include "core/orbit_cache.hpp"
+#include "core/thread_pool.hpp"
+
+namespace mandel::core {
+
+namespace {
+    // bits of mantissa a precision resolves
+    constexpr double mantissaBits[] = {24.0, 53.0, 106.0};
+
+    // pixels a series approximation is checked against, in half frame
+    // sizes from pixel (0, 0)
+    constexpr std::size_t seriesProbeCount = 8;
+    constexpr double seriesProbes[seriesProbeCount][2] = {
+        {0.0, 0.0},
+        {1.0, 0.0},
+        {2.0, 0.0},
+        {0.0, 1.0},
+        {2.0, 1.0},
+        {0.0, 2.0},
+        {1.0, 2.0},
+        {2.0, 2.0}};
+
+    // rounds of secondary references a frame gets and how many glitch
+    // regions one round picks references for
+    constexpr std::size_t maxGlitchRounds = 4;
+    constexpr std::size_t maxGlitchRegions = 16;
+}  // namespace
+
+precisionChoice SelectPrecision(
+    const view& v,
+    const int width,
+    const int height) {
+    const double increment = std::max(v.increment.x, v.increment.y);
+
+    // z stays inside the radius 2 circle until it escapes, the screen
+    // corners can be farther out
+    const double extent =
+        0.5 * static_cast<double>(std::max(width, height)) * increment;
+    const double magnitude = std::max(
+        {2.0,
+         std::fabs(v.startPos.x.m_toDouble()) + extent,
+         std::fabs(v.startPos.y.m_toDouble()) + extent});
+
+    // bits between the largest coordinate and a pixel, plus guard bits for
+    // the rounding error every iteration adds
+    const double guardBits =
+        6.0 + 0.5 * std::log2(std::max(v.maxIteration, 1));
+    const double bits = std::log2(magnitude / increment) + guardBits
+        - static_cast<double>(v.incrementScale);
+
+    if (bits <= mantissaBits[0])
+        return {precision::singleFloat, "pixel spacing resolves in float"};
+
+    if (bits <= mantissaBits[1])
+        return {precision::doubleFloat, "pixel spacing is past float"};
+
+    if (v.exponent != 2.0)
+        return {precision::doubleFloat, "only exponent 2 goes past double"};
+
+    if (bits <= mantissaBits[2])
+        return {precision::doubleDouble, "pixel spacing is past double"};
+
+    return {precision::perturbation, "pixel spacing is past double-double"};
+}
+
+namespace {
+    // GetFrameKernel of a perturbation frame with its reference orbit at
+    // reference, cached in orbitDirectory unless it is empty
+    frameKernel getPerturbationKernel(
+        const view& v,
+        const int width,
+        const int height,
+        const renderOptions& options,
+        const bigVec2& reference,
+        const std::string& orbitDirectory,
+        perturbationState& state) {
+        frameKernel result;
+
+        result.choice = {precision::perturbation, "set in the options"};
+
+        state.source = GetReferenceOrbit(
+            v,
+            reference,
+            orbitDirectory,
+            options.orbitCacheBudget,
+            state.orbit);
+
+        result.params =
+            GetKernelParams(v, width, height, &state.orbit.center);
+        result.params.bDetectGlitches = options.bDetectGlitches;
+        result.perturb = GetKernels().perturb;
+        result.state = &state;
+
+        // the corners and edge centers are the pixels farthest from the
+        // reference
+        double probeX[seriesProbeCount], probeY[seriesProbeCount];
+        double maxDeltaC = 0.0;
+
+        for (std::size_t i = 0; i < seriesProbeCount; ++i) {
+            const kernelParams& p = result.params;
+
+            const double px = p.pixelX
+                + 0.5 * seriesProbes[i][0] * static_cast<double>(width - 1);
+            const double py = p.pixelY
+                + 0.5 * seriesProbes[i][1] * static_cast<double>(height - 1);
+
+            probeX[i] = p.originX + px * p.stepXx + py * p.stepYx;
+            probeY[i] = p.originY + px * p.stepXy + py * p.stepYy;
+
+            maxDeltaC =
+                std::max(maxDeltaC, std::hypot(probeX[i], probeY[i]));
+        }
+
+        state.bla.levels.clear();
+
+        // delta_c is always 0 for julia sets
+        if (options.bUseBla) {
+            ComputeBlaTable(
+                state.orbit,
+                v.bUseJuliaSet ? 0.0 : std::ldexp(maxDeltaC, v.incrementScale),
+                state.bla);
+        }
+
+        // the series coefficients would leave the range of double along
+        // with the deltas
+        const int terms =
+            v.incrementScale == 0 ? std::max(options.seriesTerms, 0) : 0;
+
+        ComputeSeriesApproximation(
+            state.orbit,
+            v.bUseJuliaSet,
+            probeX,
+            probeY,
+            seriesProbeCount,
+            static_cast<std::size_t>(terms),
+            state.series);
+
+        return result;
+    }
+
+    // the 4 connected groups of glitched pixels, largest first
+    void findGlitchRegions(
+        const int* iterations,
+        const int width,
+        const int height,
+        std::vector<std::vector<std::uint32_t>>& regions) {
+        regions.clear();
+
+        const std::size_t count =
+            static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+
+        std::vector<bool> visited(count, false);
+        std::vector<std::uint32_t> pending;
+
+        for (std::size_t i = 0; i < count; ++i) {
+            if (visited[i] || iterations[i] != glitchedIteration)
+                continue;
+
+            regions.emplace_back();
+            std::vector<std::uint32_t>& region = regions.back();
+
+            visited[i] = true;
+            pending.push_back(static_cast<std::uint32_t>(i));
+
+            // flood fill over the 4 neighbours
+            while (!pending.empty()) {
+                const std::uint32_t pixel = pending.back();
+                pending.pop_back();
+
+                region.push_back(pixel);
+
+                const int px = static_cast<int>(pixel) % width;
+                const int py = static_cast<int>(pixel) / width;
+
+                const int neighbours[4][2] = {
+                    {px - 1, py},
+                    {px + 1, py},
+                    {px, py - 1},
+                    {px, py + 1}};
+
+                for (const auto& n : neighbours) {
+                    if (n[0] < 0 || n[0] >= width || n[1] < 0
+                        || n[1] >= height)
+                        continue;
+
+                    const std::size_t j =
+                        static_cast<std::size_t>(n[1] * width + n[0]);
+
+                    if (!visited[j] && iterations[j] == glitchedIteration) {
+                        visited[j] = true;
+                        pending.push_back(static_cast<std::uint32_t>(j));
+                    }
+                }
+            }
+        }
+
+        // the largest regions get their references first
+        std::sort(
+            regions.begin(),
+            regions.end(),
+            [](const auto& a, const auto& b) { return a.size() > b.size(); });
+    }
+
+    // renders the pixels of region with a reference inside it, centered
+    // are the kernel params of the frame with its reference at the screen
+    // center
+    void renderGlitchRegion(
+        const view& v,
+        const int width,
+        const int height,
+        const renderOptions& options,
+        const kernelParams& centered,
+        const std::vector<std::uint32_t>& region,
+        perturbationState& state,
+        int* iterations) {
+        const std::uint32_t w = static_cast<std::uint32_t>(width);
+
+        // the pixel closest to the centroid is inside the region even when
+        // it is not convex
+        double centerX = 0.0, centerY = 0.0;
+
+        for (const std::uint32_t pixel : region) {
+            centerX += static_cast<double>(pixel % w);
+            centerY += static_cast<double>(pixel / w);
+        }
+
+        centerX /= static_cast<double>(region.size());
+        centerY /= static_cast<double>(region.size());
+
+        std::uint32_t closest = region.front();
+        double closestDistance = std::numeric_limits<double>::infinity();
+
+        for (const std::uint32_t pixel : region) {
+            const double dx = static_cast<double>(pixel % w) - centerX;
+            const double dy = static_cast<double>(pixel / w) - centerY;
+
+            if (dx * dx + dy * dy < closestDistance) {
+                closestDistance = dx * dx + dy * dy;
+                closest = pixel;
+            }
+        }
+
+        // the offset of the pixel from the screen center is exact enough
+        // in double, the reference only has to be near it
+        const double px = centered.pixelX + static_cast<double>(closest % w);
+        const double py = centered.pixelY + static_cast<double>(closest / w);
+
+        const double offsetX =
+            centered.originX + px * centered.stepXx + py * centered.stepYx;
+        const double offsetY =
+            centered.originY + px * centered.stepXy + py * centered.stepYy;
+
+        const std::size_t bits = v.startPos.x.m_precision();
+
+        const bigVec2 reference {
+            v.startPos.x + bigFloat(offsetX, bits).m_ldexp(v.incrementScale),
+            v.startPos.y + bigFloat(offsetY, bits).m_ldexp(v.incrementScale)};
+
+        // secondary references are rarely wanted again, they stay out of
+        // the orbit cache
+        const frameKernel kernel = getPerturbationKernel(
+            v,
+            width,
+            height,
+            options,
+            reference,
+            {},
+            state);
+
+        kernel.m_run(region.data(), region.size(), iterations);
+    }
+}  // namespace
+
+frameKernel GetFrameKernel(
+    const view& v,
+    const int width,
+    const int height,
+    const renderOptions& options,
+    perturbationState& state) {
+    precisionChoice choice = options.bAutoPrecision
+        ? SelectPrecision(v, width, height)
+        : precisionChoice {options.floatType, "set in the options"};
+
+    if (choice.floatType == precision::perturbation && v.exponent != 2.0)
+        choice = {precision::doubleFloat, "perturbation needs exponent 2"};
+
+    frameKernel result;
+
+    if (choice.floatType == precision::perturbation) {
+        // the reference is the screen center
+        result = getPerturbationKernel(
+            v,
+            width,
+            height,
+            options,
+            v.startPos,
+            options.orbitCacheDirectory,
+            state);
+    } else {
+        result.params = GetKernelParams(v, width, height);
+        result.escape = GetKernels().m_escape(
+            options.lanes,
+            choice.floatType,
+            result.params);
+        result.bResumable = options.lanes == laneMode::refill
+            && choice.floatType != precision::doubleDouble;
+    }
+
+    result.choice = choice;
+
+    return result;
+}
+
+glitchStats CorrectGlitches(
+    const view& v,
+    const int width,
+    const int height,
+    const renderOptions& options,
+    const frameKernel& kernel,
+    int* iterations,
+    threadPool* pool) {
+    glitchStats stats;
+
+    std::vector<std::vector<std::uint32_t>> regions;
+    std::vector<perturbationState> states;
+
+    for (std::size_t round = 0; round < maxGlitchRounds; ++round) {
+        findGlitchRegions(iterations, width, height, regions);
+
+        if (regions.empty())
+            return stats;
+
+        if (round == 0) {
+            for (const auto& region : regions)
+                stats.glitchedPixels += region.size();
+        }
+
+        regions.resize(std::min(regions.size(), maxGlitchRegions));
+        states.resize(regions.size());
+
+        const auto renderRegion = [&](std::size_t r, std::size_t) {
+            renderGlitchRegion(
+                v,
+                width,
+                height,
+                options,
+                kernel.params,
+                regions[r],
+                states[r],
+                iterations);
+        };
+
+        if (pool != nullptr) {
+            pool->m_run(regions.size(), renderRegion);
+        } else {
+            for (std::size_t r = 0; r < regions.size(); ++r)
+                renderRegion(r, 0);
+        }
+
+        stats.references += regions.size();
+    }
+
+    // rebasing does not glitch
+    findGlitchRegions(iterations, width, height, regions);
+
+    frameKernel rebasing = kernel;
+    rebasing.params.bDetectGlitches = false;
+
+    for (const auto& region : regions)
+        rebasing.m_run(region.data(), region.size(), iterations);
+
+    return stats;
+}
+
+void RenderIterations(
+    const view& v,
+    const int width,
+    const int height,
+    int* iterations,
+    const renderOptions& options) {
+    perturbationState state;
+    frameKernel kernel = GetFrameKernel(v, width, height, options, state);
+
+    std::vector<std::uint32_t> pixels;
+
+    // boundary tracing reads the pixels caught in a cycle from zX
+    std::vector<double> zX, zY;
+
+    if (kernel.bResumable && options.fill == fillMode::boundaryTrace) {
+        const std::size_t count =
+            static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+
+        zX.assign(count, std::numeric_limits<double>::infinity());
+        zY.resize(count);
+
+        kernel.params.zX = zX.data();
+        kernel.params.zY = zY.data();
+    }
+
+    FillRect(
+        kernel,
+        options.fill,
+        width,
+        {0, 0, width, height},
+        iterations,
+        pixels);
+
+    if (kernel.params.bDetectGlitches)
+        CorrectGlitches(v, width, height, options, kernel, iterations);
+}
+
+namespace {
+    // SetColor of fragment.glsl for a count of n
+    void setColor(
+        const palette& p,
+        const float invMax,
+        const int n,
+        std::uint8_t* rgba) {
+        constexpr int paletteMaxIndex = 2;  // size - 1
+
+        const float v = static_cast<float>(n) * invMax * paletteMaxIndex;
+
+        const int index = std::clamp(static_cast<int>(v), 0, paletteMaxIndex);
+        const float magic =
+            (0.5f * std::sin(p.colorPeriod * static_cast<float>(n))) + 0.5f;
+
+        const int minVal = std::min(index + 1, paletteMaxIndex);
+
+        const float* from =
+            p.colorPalette + static_cast<std::size_t>(index) * 3;
+        const float* to = p.colorPalette + static_cast<std::size_t>(minVal) * 3;
+
+        for (std::size_t c = 0; c < 3; ++c) {
+            const float color = from[c] + (to[c] - from[c]) * magic;
+
+            rgba[c] = static_cast<std::uint8_t>(
+                std::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+
+        rgba[3] = 255;
+    }
+}  // namespace
+
+void ColorIterations(
+    const palette& p,
+    const int maxIteration,
+    const int* iterations,
+    const std::size_t count,
+    std::uint8_t* rgba) {
+    const float invMax =
+        maxIteration > 0 ? 1.0f / static_cast<float>(maxIteration) : 0.0f;
+
+    // the color only depends on the count, so every count of the frame is
+    // colored once and the pixels copy theirs, counts outside of
+    // [0, maxIteration] are colored on their own
+    const std::size_t colorCount =
+        static_cast<std::size_t>(std::max(maxIteration, 0)) + 1;
+
+    std::vector<std::uint32_t> colors(colorCount);
+
+    for (std::size_t n = 0; n < colorCount; ++n) {
+        setColor(
+            p,
+            invMax,
+            static_cast<int>(n),
+            reinterpret_cast<std::uint8_t*>(colors.data() + n));
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const int n = iterations[i];
+        // negative counts wrap past colorCount
+        const std::size_t color = static_cast<unsigned>(n);
+
+        if (color < colorCount)
+            std::memcpy(rgba + i * 4, colors.data() + color, 4);
+        else
+            setColor(p, invMax, n, rgba + i * 4);
+    }
+}
+
+void Render(
+    const view& v,
+    const palette& p,
+    const int width,
+    const int height,
+    std::uint8_t* rgba) {
+    const std::size_t count =
+        static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+
+    std::vector<int> iterations(count);
+
+    RenderIterations(v, width, height, iterations.data());
+    ColorIterations(p, v.maxIteration, iterations.data(), count, rgba);
+}
+
+}  // namespace mandel::core
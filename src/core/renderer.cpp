@@ -0,0 +1,783 @@
+#include "core/renderer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <mutex>
+
+namespace mandel::core {
+namespace {
+    std::size_t getThreadCount(const renderOptions& options) {
+        return static_cast<std::size_t>(std::max(options.threadCount, 0));
+    }
+
+    // whether a and b render the same iterations, the threads, the orbit
+    // cache and verification do not change them and the tile cache only
+    // moves pixels by less than one
+    bool isSameOutput(const renderOptions& a, const renderOptions& b) {
+        return a.floatType == b.floatType
+            && a.bAutoPrecision == b.bAutoPrecision
+            && a.bUseBla == b.bUseBla && a.seriesTerms == b.seriesTerms
+            && a.bDetectGlitches == b.bDetectGlitches && a.lanes == b.lanes
+            && a.fill == b.fill && a.tileSize == b.tileSize;
+    }
+
+    // pixels of one kernel call of m_resume
+    constexpr std::size_t resumeChunkSize = 4096;
+
+    // pixels m_renderCached looks ahead along a row for the next tile
+    constexpr int markStride = 32;
+
+    std::int64_t floorDiv(const std::int64_t a, const std::int64_t b) {
+        return a / b - (a % b != 0 && (a < 0) != (b < 0) ? 1 : 0);
+    }
+
+    // whether b is a with a higher maxIteration
+    bool isRaisedMaxIteration(const view& a, const view& b) {
+        view raised = a;
+        raised.maxIteration = b.maxIteration;
+
+        return b.maxIteration > a.maxIteration && IsSameView(raised, b);
+    }
+
+    // moves the pixels of a width x height frame so that pixel (x, y) gets
+    // the one at (x + offsetX, y + offsetY), the pixels with nothing to get
+    // keep what they had, |offsetX| < width and |offsetY| < height
+    template<typename T>
+    void shiftFrame(
+        T* frame,
+        const int width,
+        const int height,
+        const int offsetX,
+        const int offsetY) {
+        const int toX = std::max(-offsetX, 0);
+        const int fromX = std::max(offsetX, 0);
+        const std::size_t rowSize =
+            static_cast<std::size_t>(width - std::abs(offsetX)) * sizeof(T);
+
+        const auto moveRow = [&](const int y) {
+            std::memmove(
+                frame + static_cast<std::size_t>(y * width + toX),
+                frame + static_cast<std::size_t>((y + offsetY) * width + fromX),
+                rowSize);
+        };
+
+        // rows are moved before they are overwritten
+        if (offsetY > 0) {
+            for (int y = 0; y < height - offsetY; ++y)
+                moveRow(y);
+        } else {
+            for (int y = height - 1; y >= -offsetY; --y)
+                moveRow(y);
+        }
+    }
+}  // namespace
+
+renderer::renderer(const renderOptions& options) :
+    m_options(options),
+    m_pool(getThreadCount(options)) {
+    m_tileCache.m_setBudget(options.tileCacheBudget);
+}
+
+void renderer::setOptions(const renderOptions& options) {
+    if (options.threadCount != m_options.threadCount)
+        m_pool.m_resize(getThreadCount(options));
+
+    if (!isSameOutput(options, m_options)) {
+        m_bFrameValid = false;
+        m_tileCache.m_clear();
+    }
+
+    // the kept frame was not verified
+    if (options.bVerifyFill && !m_options.bVerifyFill)
+        m_bFrameValid = false;
+
+    if (options.tileCacheBudget != m_options.tileCacheBudget)
+        m_tileCache.m_setBudget(options.tileCacheBudget);
+
+    m_options = options;
+}
+
+bool renderer::m_render(
+    const view& v,
+    const int width,
+    const int height,
+    int* iterations,
+    double* zX,
+    double* zY) {
+    const auto startTime = std::chrono::steady_clock::now();
+
+    frameKernel kernel =
+        GetFrameKernel(v, width, height, m_options, m_perturbation);
+
+    const auto orbitTime = std::chrono::steady_clock::now();
+
+    const std::size_t count =
+        static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+
+    const pixelRect frameRect {0, 0, width, height};
+
+    const bool bKeepZ = zX != nullptr && zY != nullptr && kernel.bResumable;
+
+    if (!bKeepZ && kernel.bResumable
+        && m_options.fill == fillMode::boundaryTrace) {
+        m_traceZX.resize(count);
+        m_traceZY.resize(count);
+
+        zX = m_traceZX.data();
+        zY = m_traceZY.data();
+    }
+
+    if (kernel.bResumable && zX != nullptr && zY != nullptr) {
+        // pixels the fill decides are never iterated
+        std::fill_n(zX, count, std::numeric_limits<double>::infinity());
+
+        kernel.params.zX = zX;
+        kernel.params.zY = zY;
+    }
+
+    const fillStats filled =
+        m_fillTiles(kernel, m_options.fill, width, frameRect, iterations);
+
+    m_stats.glitches = kernel.params.bDetectGlitches
+        ? CorrectGlitches(
+            v,
+            width,
+            height,
+            m_options,
+            kernel,
+            iterations,
+            &m_pool)
+        : glitchStats {};
+
+    m_setFrameStats(kernel, filled, m_tileCount, count, startTime, orbitTime);
+
+    if (m_options.bVerifyFill && m_options.fill != fillMode::everyPixel) {
+        m_verifyIterations.resize(count);
+        int* expected = m_verifyIterations.data();
+
+        frameKernel reference = kernel;
+        reference.params.zX = reference.params.zY = nullptr;
+
+        m_fillTiles(
+            reference,
+            fillMode::everyPixel,
+            width,
+            frameRect,
+            expected);
+
+        if (kernel.params.bDetectGlitches) {
+            CorrectGlitches(
+                v,
+                width,
+                height,
+                m_options,
+                reference,
+                expected,
+                &m_pool);
+        }
+
+        for (std::size_t i = 0; i < count; ++i) {
+            if (iterations[i] != expected[i])
+                ++m_stats.fillMismatches;
+        }
+    }
+
+    return bKeepZ;
+}
+
+bool renderer::m_update(const view& v, const int width, const int height) {
+    const bool bCache = m_options.tileCacheBudget > 0 && !m_options.bVerifyFill;
+
+    if (m_bFrameValid && width == m_frameWidth && height == m_frameHeight) {
+        if (IsSameView(v, m_frameView)) {
+            m_stats.bKept = true;
+            return false;
+        }
+
+        int offsetX, offsetY;
+
+        // verification compares whole frames rendered pixel by pixel, and
+        // the tile cache moves frames along its samples, which resumed or
+        // moved pixels would not be
+        if (!m_options.bVerifyFill && !m_bFrameCached
+            && ((isRaisedMaxIteration(m_frameView, v)
+                 && m_resume(v, width, height))
+                || (!bCache
+                    && GetPixelOffset(m_frameView, v, offsetX, offsetY)
+                    && m_pan(v, width, height, offsetX, offsetY)))) {
+            m_frameView = v;
+            return true;
+        }
+    }
+
+    const std::size_t count = static_cast<std::size_t>(std::max(width, 0))
+        * static_cast<std::size_t>(std::max(height, 0));
+
+    m_frame.resize(count);
+    m_frameZX.resize(count);
+    m_frameZY.resize(count);
+
+    m_bFrameCached = bCache && count > 0;
+
+    if (m_bFrameCached) {
+        m_renderCached(v, width, height);
+        m_bFrameZ = false;
+    } else {
+        m_bFrameZ = m_render(
+            v,
+            width,
+            height,
+            m_frame.data(),
+            m_frameZX.data(),
+            m_frameZY.data());
+    }
+
+    m_frameView = v;
+    m_frameWidth = width;
+    m_frameHeight = height;
+    m_framePrecision = m_stats.tier.floatType;
+    m_bFrameValid = true;
+
+    return true;
+}
+
+void renderer::m_renderCached(
+    const view& v,
+    const int width,
+    const int height) {
+    constexpr int tileSize = tileCache::tileSize;
+    constexpr std::size_t tileSamples =
+        static_cast<std::size_t>(tileSize * tileSize);
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    const tileCache::frameLayout layout =
+        m_tileCache.m_getLayout(v, width, height);
+
+    // the kernel covers the tiles past the border too, the series of a
+    // perturbation frame is checked at the corners of what it covers
+    frameKernel kernel = GetFrameKernel(
+        v,
+        width + 2 * layout.margin,
+        height + 2 * layout.margin,
+        m_options,
+        m_perturbation);
+
+    const auto orbitTime = std::chrono::steady_clock::now();
+
+    // the tiles the corners fall into bound the ones of the frame
+    std::int64_t firstX = std::numeric_limits<std::int64_t>::max();
+    std::int64_t firstY = firstX;
+    std::int64_t lastX = std::numeric_limits<std::int64_t>::min();
+    std::int64_t lastY = lastX;
+
+    for (const int y : {0, height - 1}) {
+        for (const int x : {0, width - 1}) {
+            std::int64_t i, j;
+            layout.m_getSample(x, y, i, j);
+
+            firstX = std::min(firstX, floorDiv(i, tileSize));
+            firstY = std::min(firstY, floorDiv(j, tileSize));
+            lastX = std::max(lastX, floorDiv(i, tileSize));
+            lastY = std::max(lastY, floorDiv(j, tileSize));
+        }
+    }
+
+    const std::size_t tilesX = static_cast<std::size_t>(lastX - firstX + 1);
+    const std::size_t tilesY = static_cast<std::size_t>(lastY - firstY + 1);
+
+    // the tile of a pixel as an index into m_cacheTiles and its sample as
+    // one into the tile, the corners bound the samples from below too
+    const std::size_t size = tileSize;
+
+    const auto getIndices = [&](const int x,
+                                const int y,
+                                std::size_t& tile,
+                                std::size_t& sample) {
+        std::int64_t i, j;
+        layout.m_getSample(x, y, i, j);
+
+        const std::size_t column =
+            static_cast<std::size_t>(i - firstX * tileSize);
+        const std::size_t row = static_cast<std::size_t>(j - firstY * tileSize);
+
+        tile = row / size * tilesX + column / size;
+        sample = row % size * size + column % size;
+    };
+
+    // a frame rotated against the samples does not need every tile of the
+    // bounds, along a row the tile column and the tile row only go one way
+    // each, so the pixels between two pixels of one tile are in it too
+    std::vector<std::uint8_t> needed(tilesX * tilesY, 0);
+
+    for (int y = 0; y < height; ++y) {
+        std::size_t tile, sample;
+        getIndices(0, y, tile, sample);
+        needed[tile] = 1;
+
+        for (int x = 0; x < width - 1;) {
+            int next = std::min(x + markStride, width - 1);
+            std::size_t nextTile;
+
+            for (;;) {
+                getIndices(next, y, nextTile, sample);
+
+                if (nextTile == tile || next == x + 1)
+                    break;
+
+                next = x + (next - x) / 2;
+            }
+
+            needed[nextTile] = 1;
+            tile = nextTile;
+            x = next;
+        }
+    }
+
+    m_cacheTiles.assign(tilesX * tilesY, nullptr);
+    m_missingTiles.clear();
+
+    for (std::size_t tile = 0; tile < m_cacheTiles.size(); ++tile) {
+        if (needed[tile] == 0)
+            continue;
+
+        m_cacheTiles[tile] = m_tileCache.m_find(
+            layout,
+            kernel.choice.floatType,
+            firstX + static_cast<std::int64_t>(tile % tilesX),
+            firstY + static_cast<std::int64_t>(tile / tilesX));
+
+        if (!m_cacheTiles[tile]) {
+            m_cacheTiles[tile] =
+                std::make_shared<std::vector<int>>(tileSamples);
+            m_missingTiles.push_back(tile);
+        }
+    }
+
+    m_tilePixels.resize(m_pool.m_threadCount());
+
+    std::mutex mutex;
+    fillStats filled;
+    glitchStats glitches;
+
+    // every tile is a frame of its own, with the orbit and tables of the
+    // frame kernel
+    m_pool.m_run(
+        m_missingTiles.size(),
+        [&](std::size_t task, std::size_t worker) {
+            const std::size_t tile = m_missingTiles[task];
+
+            const view tileView = m_tileCache.m_getTileView(
+                v,
+                layout,
+                firstX + static_cast<std::int64_t>(tile % tilesX),
+                firstY + static_cast<std::int64_t>(tile / tilesX));
+
+            frameKernel tileKernel = kernel;
+
+            tileKernel.params = GetKernelParams(
+                tileView,
+                tileSize,
+                tileSize,
+                kernel.state != nullptr ? &kernel.state->orbit.center
+                                        : nullptr);
+            tileKernel.params.bDetectGlitches = kernel.params.bDetectGlitches;
+
+            // see m_traceZX
+            std::vector<double> zX, zY;
+
+            if (tileKernel.bResumable
+                && m_options.fill == fillMode::boundaryTrace) {
+                zX.assign(
+                    tileSamples,
+                    std::numeric_limits<double>::infinity());
+                zY.resize(tileSamples);
+
+                tileKernel.params.zX = zX.data();
+                tileKernel.params.zY = zY.data();
+            }
+
+            int* iterations = m_cacheTiles[tile]->data();
+
+            const fillStats stats = FillRect(
+                tileKernel,
+                m_options.fill,
+                tileSize,
+                {0, 0, tileSize, tileSize},
+                iterations,
+                m_tilePixels[worker]);
+
+            const glitchStats corrected = tileKernel.params.bDetectGlitches
+                ? CorrectGlitches(
+                    tileView,
+                    tileSize,
+                    tileSize,
+                    m_options,
+                    tileKernel,
+                    iterations)
+                : glitchStats {};
+
+            const std::lock_guard<std::mutex> lock(mutex);
+
+            filled.computedPixels += stats.computedPixels;
+            filled.periodicPixels += stats.periodicPixels;
+            glitches.glitchedPixels += corrected.glitchedPixels;
+            glitches.references += corrected.references;
+        });
+
+    for (const std::size_t tile : m_missingTiles) {
+        m_tileCache.m_insert(
+            layout,
+            kernel.choice.floatType,
+            firstX + static_cast<std::int64_t>(tile % tilesX),
+            firstY + static_cast<std::int64_t>(tile / tilesX),
+            m_cacheTiles[tile]);
+    }
+
+    m_cacheSamples.assign(m_cacheTiles.size(), nullptr);
+
+    for (std::size_t tile = 0; tile < m_cacheTiles.size(); ++tile) {
+        if (m_cacheTiles[tile])
+            m_cacheSamples[tile] = m_cacheTiles[tile]->data();
+    }
+
+    m_pool.m_run(
+        static_cast<std::size_t>(height),
+        [&](std::size_t row, std::size_t) {
+            const int y = static_cast<int>(row);
+            int* pixels =
+                m_frame.data() + row * static_cast<std::size_t>(width);
+
+            for (int x = 0; x < width; ++x) {
+                std::size_t tile, sample;
+                getIndices(x, y, tile, sample);
+
+                pixels[x] = m_cacheSamples[tile][sample];
+            }
+        });
+
+    // the tiles are the cache's to drop now
+    m_cacheTiles.clear();
+
+    m_setFrameStats(
+        kernel,
+        filled,
+        m_missingTiles.size(),
+        m_frame.size(),
+        startTime,
+        orbitTime);
+    m_stats.glitches = glitches;
+    m_stats.cache = m_tileCache.stats();
+}
+
+bool renderer::m_resume(const view& v, const int width, const int height) {
+    // subdivide fills a rect by its border at the lower maxIteration, the
+    // higher one can split it where a fresh frame would
+    if (m_options.fill == fillMode::subdivide)
+        return false;
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    frameKernel kernel =
+        GetFrameKernel(v, width, height, m_options, m_perturbation);
+
+    const auto orbitTime = std::chrono::steady_clock::now();
+
+    // the escaped pixels of another precision would not be the ones of a
+    // frame rendered anew
+    if (kernel.choice.floatType != m_framePrecision)
+        return false;
+
+    const int lastMaxIteration = m_frameView.maxIteration;
+    const bool bResume = m_bFrameZ && kernel.bResumable;
+
+    // pixels with a nan z are inside and stay there, the ones the fill
+    // decided without a z start over
+    std::size_t insidePixels = 0;
+
+    m_resumePixels.clear();
+    m_restartPixels.clear();
+
+    for (std::size_t i = 0; i < m_frame.size(); ++i) {
+        if (m_frame[i] != lastMaxIteration)
+            continue;
+
+        if (!bResume || std::isinf(m_frameZX[i])) {
+            m_restartPixels.push_back(static_cast<std::uint32_t>(i));
+        } else if (std::isnan(m_frameZX[i])) {
+            m_frame[i] = v.maxIteration;
+            ++insidePixels;
+        } else {
+            m_resumePixels.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+
+    if (bResume) {
+        kernel.params.zX = m_frameZX.data();
+        kernel.params.zY = m_frameZY.data();
+    }
+
+    frameKernel resumeKernel = kernel;
+    resumeKernel.params.bResume = true;
+
+    std::mutex mutex;
+    fillStats resumed;
+
+    resumed.computedPixels = m_resumePixels.size() + m_restartPixels.size();
+    resumed.periodicPixels = insidePixels;
+
+    std::size_t chunkCount = 0;
+
+    const auto runPixels = [&](const frameKernel& pixelKernel,
+                               const std::vector<std::uint32_t>& pixels) {
+        const std::size_t chunks =
+            (pixels.size() + resumeChunkSize - 1) / resumeChunkSize;
+
+        m_pool.m_run(chunks, [&](std::size_t chunk, std::size_t) {
+            const std::size_t first = chunk * resumeChunkSize;
+
+            const std::size_t periodic = pixelKernel.m_run(
+                pixels.data() + first,
+                std::min(resumeChunkSize, pixels.size() - first),
+                m_frame.data());
+
+            const std::lock_guard<std::mutex> lock(mutex);
+
+            resumed.periodicPixels += periodic;
+        });
+
+        chunkCount += chunks;
+    };
+
+    runPixels(resumeKernel, m_resumePixels);
+    runPixels(kernel, m_restartPixels);
+
+    // kept pixels can not be glitched, the frame was corrected already
+    m_stats.glitches = kernel.params.bDetectGlitches
+        ? CorrectGlitches(
+            v,
+            width,
+            height,
+            m_options,
+            kernel,
+            m_frame.data(),
+            &m_pool)
+        : glitchStats {};
+
+    m_setFrameStats(
+        kernel,
+        resumed,
+        chunkCount,
+        m_frame.size(),
+        startTime,
+        orbitTime);
+    m_stats.resumedPixels = m_resumePixels.size();
+
+    m_bFrameZ = bResume;
+
+    return true;
+}
+
+bool renderer::m_pan(
+    const view& v,
+    const int width,
+    const int height,
+    const int offsetX,
+    const int offsetY) {
+    // subdivide fills the strips by borders a fresh frame does not have
+    if (std::abs(offsetX) >= width || std::abs(offsetY) >= height
+        || m_options.fill == fillMode::subdivide)
+        return false;
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    frameKernel kernel =
+        GetFrameKernel(v, width, height, m_options, m_perturbation);
+
+    const auto orbitTime = std::chrono::steady_clock::now();
+
+    if (kernel.choice.floatType != m_framePrecision
+        || kernel.perturb != nullptr)
+        return false;
+
+    // the frame counted from the same lattice corner at the same rounding,
+    // an offset that only rounds to whole pixels lands between the points
+    const kernelParams& params = kernel.params;
+    const kernelParams kept = GetKernelParams(m_frameView, width, height);
+
+    if (params.originX != kept.originX || params.originY != kept.originY
+        || params.originXLo != kept.originXLo
+        || params.originYLo != kept.originYLo
+        || params.pixelX != kept.pixelX + offsetX
+        || params.pixelY != kept.pixelY + offsetY)
+        return false;
+
+    const bool bKeepZ = m_bFrameZ && kernel.bResumable;
+
+    shiftFrame(m_frame.data(), width, height, offsetX, offsetY);
+
+    if (bKeepZ) {
+        shiftFrame(m_frameZX.data(), width, height, offsetX, offsetY);
+        shiftFrame(m_frameZY.data(), width, height, offsetX, offsetY);
+
+        kernel.params.zX = m_frameZX.data();
+        kernel.params.zY = m_frameZY.data();
+    }
+
+    // the rows the frame had nothing for and the columns of the rows left
+    const int keptY0 = std::max(-offsetY, 0);
+    const int keptY1 = height - std::max(offsetY, 0);
+
+    const pixelRect strips[] = {
+        {0, 0, width, keptY0},
+        {0, keptY1, width, height},
+        {0, keptY0, std::max(-offsetX, 0), keptY1},
+        {width - std::max(offsetX, 0), keptY0, width, keptY1}};
+
+    fillStats filled;
+    std::size_t tileCount = 0;
+
+    for (const pixelRect& strip : strips) {
+        if (strip.x1 <= strip.x0 || strip.y1 <= strip.y0)
+            continue;
+
+        if (bKeepZ) {
+            for (int y = strip.y0; y < strip.y1; ++y) {
+                std::fill(
+                    m_frameZX.begin() + y * width + strip.x0,
+                    m_frameZX.begin() + y * width + strip.x1,
+                    std::numeric_limits<double>::infinity());
+            }
+        }
+
+        const fillStats stats = m_fillTiles(
+            kernel,
+            m_options.fill,
+            width,
+            strip,
+            m_frame.data());
+
+        filled.computedPixels += stats.computedPixels;
+        filled.periodicPixels += stats.periodicPixels;
+        tileCount += m_tileCount;
+    }
+
+    // only the new strips can be glitched
+    m_stats.glitches = kernel.params.bDetectGlitches
+        ? CorrectGlitches(
+            v,
+            width,
+            height,
+            m_options,
+            kernel,
+            m_frame.data(),
+            &m_pool)
+        : glitchStats {};
+
+    m_setFrameStats(
+        kernel,
+        filled,
+        tileCount,
+        m_frame.size(),
+        startTime,
+        orbitTime);
+    m_stats.panX = offsetX;
+    m_stats.panY = offsetY;
+
+    m_bFrameZ = bKeepZ;
+
+    return true;
+}
+
+void renderer::m_setFrameStats(
+    const frameKernel& kernel,
+    const fillStats& filled,
+    const std::size_t tileCount,
+    const std::size_t pixelCount,
+    const timePoint startTime,
+    const timePoint orbitTime) {
+    m_stats.renderTime = std::chrono::duration<double, std::milli>(
+                             std::chrono::steady_clock::now() - startTime)
+                             .count();
+    m_stats.tileCount = tileCount;
+    m_stats.threadCount = m_pool.m_threadCount();
+    m_stats.stolenTiles = m_pool.m_stealCount();
+    m_stats.kernelName = GetKernels().name;
+    m_stats.tier = kernel.choice;
+    m_stats.periodicPixels = filled.periodicPixels;
+    m_stats.periodicFraction = pixelCount > 0
+        ? static_cast<double>(filled.periodicPixels)
+            / static_cast<double>(pixelCount)
+        : 0.0;
+    m_stats.computedPixels = filled.computedPixels;
+    m_stats.fillMismatches = 0;
+    m_stats.bKept = false;
+    m_stats.resumedPixels = 0;
+    m_stats.panX = 0;
+    m_stats.panY = 0;
+
+    if (kernel.state != nullptr) {
+        m_stats.referenceTime = std::chrono::duration<double, std::milli>(
+                                    orbitTime - startTime)
+                                    .count();
+        m_stats.referenceSource = m_perturbation.source;
+        m_stats.referenceLength = m_perturbation.orbit.x.size();
+        m_stats.blaLevels = m_perturbation.bla.levels.size();
+        m_stats.seriesSkip = m_perturbation.series.skip;
+    } else {
+        m_stats.referenceTime = 0.0;
+        m_stats.referenceSource = orbitSource::computed;
+        m_stats.referenceLength = 0;
+        m_stats.blaLevels = 0;
+        m_stats.seriesSkip = 0;
+    }
+}
+
+fillStats renderer::m_fillTiles(
+    const frameKernel& kernel,
+    const fillMode mode,
+    const int width,
+    const pixelRect& area,
+    int* iterations) {
+    const int tileSize = std::max(m_options.tileSize, 1);
+    const int tilesX = (area.x1 - area.x0 + tileSize - 1) / tileSize;
+    const int tilesY = (area.y1 - area.y0 + tileSize - 1) / tileSize;
+
+    m_tileCount = static_cast<std::size_t>(tilesX * tilesY);
+    m_tilePixels.resize(m_pool.m_threadCount());
+
+    std::mutex mutex;
+    fillStats total;
+
+    m_pool.m_run(m_tileCount, [&](std::size_t tile, std::size_t worker) {
+        const int tileX = area.x0 + static_cast<int>(tile) % tilesX * tileSize;
+        const int tileY = area.y0 + static_cast<int>(tile) / tilesX * tileSize;
+
+        const pixelRect rect {
+            tileX,
+            tileY,
+            std::min(tileX + tileSize, area.x1),
+            std::min(tileY + tileSize, area.y1)};
+
+        const fillStats stats = FillRect(
+            kernel,
+            mode,
+            width,
+            rect,
+            iterations,
+            m_tilePixels[worker]);
+
+        const std::lock_guard<std::mutex> lock(mutex);
+
+        total.computedPixels += stats.computedPixels;
+        total.periodicPixels += stats.periodicPixels;
+    });
+
+    return total;
+}
+
+}  // namespace mandel::core
@@ -0,0 +1,142 @@
+#include "core/series.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mandel::core {
+namespace {
+    // largest relative distance between the series and a probe, the same
+    // bound the bla steps keep
+    constexpr double seriesTolerance = 1.0 / 4294967296.0;
+
+    // the series of coefficients ax, ay at t
+    void evaluate(
+        const std::vector<double>& ax,
+        const std::vector<double>& ay,
+        const double tx,
+        const double ty,
+        double& x,
+        double& y) {
+        x = 0.0;
+        y = 0.0;
+
+        for (std::size_t i = ax.size(); i-- > 0;) {
+            const double newX = x * tx - y * ty + ax[i];
+            const double newY = x * ty + y * tx + ay[i];
+
+            x = newX;
+            y = newY;
+        }
+
+        const double newX = x * tx - y * ty;
+        const double newY = x * ty + y * tx;
+
+        x = newX;
+        y = newY;
+    }
+}  // namespace
+
+void ComputeSeriesApproximation(
+    const referenceOrbit& orbit,
+    const bool bUseJuliaSet,
+    const double* probeX,
+    const double* probeY,
+    const std::size_t probeCount,
+    const std::size_t terms,
+    seriesApproximation& series) {
+    series.skip = 0;
+    series.radius = 0.0;
+
+    for (std::size_t i = 0; i < probeCount; ++i)
+        series.radius =
+            std::max(series.radius, std::hypot(probeX[i], probeY[i]));
+
+    series.ax.assign(terms, 0.0);
+    series.ay.assign(terms, 0.0);
+
+    if (terms == 0 || !(series.radius > 0.0))
+        return;
+
+    const double radius = series.radius;
+
+    // delta = u at the start index
+    series.ax[0] = radius;
+
+    std::vector<double> nextX(terms), nextY(terms);
+
+    std::vector<double> deltaX(probeX, probeX + probeCount);
+    std::vector<double> deltaY(probeY, probeY + probeCount);
+
+    for (std::size_t k = orbit.startIndex; k + 1 < orbit.startEnd; ++k) {
+        const double zx2 = orbit.x[k] + orbit.x[k];
+        const double zy2 = orbit.y[k] + orbit.y[k];
+
+        // delta_(k + 1) = 2 Z_k delta_k + delta_k^2 + delta_c, the square
+        // of the series adds the products of every pair of lower powers
+        for (std::size_t j = 0; j < terms; ++j) {
+            double x = zx2 * series.ax[j] - zy2 * series.ay[j];
+            double y = zx2 * series.ay[j] + zy2 * series.ax[j];
+
+            for (std::size_t i = 0; i < j; ++i) {
+                const std::size_t o = j - 1 - i;
+
+                x += series.ax[i] * series.ax[o] - series.ay[i] * series.ay[o];
+                y += series.ax[i] * series.ay[o] + series.ay[i] * series.ax[o];
+            }
+
+            nextX[j] = x;
+            nextY[j] = y;
+        }
+
+        if (!bUseJuliaSet)
+            nextX[0] += radius;
+
+        bool bValid = true;
+
+        for (std::size_t i = 0; i < probeCount && bValid; ++i) {
+            const double dx = deltaX[i];
+            const double dy = deltaY[i];
+
+            const double tx = orbit.x[k] + orbit.x[k] + dx;
+            const double ty = orbit.y[k] + orbit.y[k] + dy;
+
+            const double dcx = bUseJuliaSet ? 0.0 : probeX[i];
+            const double dcy = bUseJuliaSet ? 0.0 : probeY[i];
+
+            deltaX[i] = tx * dx - ty * dy + dcx;
+            deltaY[i] = tx * dy + ty * dx + dcy;
+
+            const double zx = orbit.x[k + 1] + deltaX[i];
+            const double zy = orbit.y[k + 1] + deltaY[i];
+
+            const double r2 = zx * zx + zy * zy;
+            const double d2 =
+                deltaX[i] * deltaX[i] + deltaY[i] * deltaY[i];
+
+            double sx, sy;
+            evaluate(
+                nextX,
+                nextY,
+                probeX[i] / radius,
+                probeY[i] / radius,
+                sx,
+                sy);
+
+            const double ex = sx - deltaX[i];
+            const double ey = sy - deltaY[i];
+
+            bValid = r2 <= 4.0 && d2 <= r2
+                && ex * ex + ey * ey
+                    <= seriesTolerance * seriesTolerance * d2;
+        }
+
+        if (!bValid)
+            break;
+
+        series.ax.swap(nextX);
+        series.ay.swap(nextY);
+        ++series.skip;
+    }
+}
+
+}  // namespace mandel::core
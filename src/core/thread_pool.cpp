@@ -0,0 +1,159 @@
+#include "core/thread_pool.hpp"
+
+#include <algorithm>
+
+namespace mandel::core {
+
+threadPool::threadPool(const std::size_t threadCount) {
+    m_start(threadCount);
+}
+
+threadPool::~threadPool() {
+    m_stop();
+}
+
+void threadPool::m_resize(const std::size_t threadCount) {
+    m_stop();
+    m_start(threadCount);
+}
+
+void threadPool::m_start(std::size_t threadCount) {
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    m_quit = false;
+
+    m_queues.clear();
+    for (std::size_t i = 0; i < threadCount; ++i)
+        m_queues.push_back(std::make_unique<taskQueue>());
+
+    // worker 0 is the thread that calls m_run
+    for (std::size_t i = 1; i < threadCount; ++i) {
+        m_threads.emplace_back(
+            &threadPool::m_workerLoop,
+            this,
+            i,
+            m_generation);
+    }
+}
+
+void threadPool::m_stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wakeUp.notify_all();
+
+    for (std::thread& thread : m_threads)
+        thread.join();
+
+    m_threads.clear();
+}
+
+void threadPool::m_run(const std::size_t taskCount, const taskFunc& func) {
+    if (taskCount == 0)
+        return;
+
+    m_steals.store(0, std::memory_order_relaxed);
+
+    // contiguous blocks of tasks per worker, a thief takes the far end of
+    // a block first
+    const std::size_t workers = m_threadCount();
+
+    for (std::size_t w = 0; w < workers; ++w) {
+        const std::size_t begin = taskCount * w / workers;
+        const std::size_t end = taskCount * (w + 1) / workers;
+
+        std::lock_guard<std::mutex> lock(m_queues[w]->mutex);
+        for (std::size_t task = begin; task < end; ++task)
+            m_queues[w]->tasks.push_back(task);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_func = &func;
+        m_busyWorkers = workers - 1;
+        ++m_generation;
+    }
+    m_wakeUp.notify_all();
+
+    m_work(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_finished.wait(lock, [this]() { return m_busyWorkers == 0; });
+
+    m_func = nullptr;
+}
+
+void threadPool::m_workerLoop(
+    const std::size_t worker,
+    std::size_t generation) {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeUp.wait(lock, [&]() {
+                return m_quit || m_generation != generation;
+            });
+
+            if (m_quit)
+                return;
+
+            generation = m_generation;
+        }
+
+        m_work(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_busyWorkers;
+        }
+        m_finished.notify_one();
+    }
+}
+
+void threadPool::m_work(const std::size_t worker) {
+    std::size_t task;
+
+    // no tasks are queued while a run is going on, so once every deque is
+    // empty there is nothing left to start
+    while (m_pop(worker, task) || m_steal(worker, task))
+        (*m_func)(task, worker);
+}
+
+bool threadPool::m_pop(const std::size_t worker, std::size_t& task) {
+    taskQueue& queue = *m_queues[worker];
+
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.tasks.empty())
+        return false;
+
+    task = queue.tasks.back();
+    queue.tasks.pop_back();
+
+    return true;
+}
+
+bool threadPool::m_steal(const std::size_t worker, std::size_t& task) {
+    const std::size_t workers = m_threadCount();
+
+    for (std::size_t i = 1; i < workers; ++i) {
+        taskQueue& queue = *m_queues[(worker + i) % workers];
+
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (queue.tasks.empty())
+            continue;
+
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+
+        m_steals.fetch_add(1, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    return false;
+}
+
+}  // namespace mandel::core
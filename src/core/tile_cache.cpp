@@ -0,0 +1,325 @@
+#include "core/tile_cache.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace mandel::core {
+namespace {
+    // sheets kept at once, a new one past it replaces the least recently
+    // used one with all of its tiles
+    constexpr std::size_t maxSheets = 64;
+
+    // samples a frame center may be from the anchor of its sheet, far past
+    // any frame size and still exact in double
+    constexpr double maxSheetOffset = 1 << 30;
+
+    // the anchor of a sheet is a multiple of 2^anchorBits samples of the
+    // level it is made at, the tiles of the levels up to anchorBits above
+    // it then start on whole pixels of the lattice of GetKernelParams
+    constexpr int anchorBits = 16;
+
+    constexpr std::size_t tileSamples =
+        static_cast<std::size_t>(tileCache::tileSize * tileCache::tileSize);
+
+    // the samples of a tile with its shared pointer, list node and index
+    // entry, roughly
+    constexpr std::size_t tileBytes =
+        tileSamples * sizeof(int) + 16 * sizeof(void*);
+
+    // whether frames of a and b iterate the same points the same way
+    bool isSameSet(const view& a, const view& b) {
+        if (a.maxIteration != b.maxIteration
+            || a.bUseJuliaSet != b.bUseJuliaSet || a.exponent != b.exponent)
+            return false;
+
+        return !a.bUseJuliaSet
+            || (a.juliaConstant.x == b.juliaConstant.x
+                && a.juliaConstant.y == b.juliaConstant.y);
+    }
+}  // namespace
+
+std::size_t tileCache::tileKeyHash::operator()(
+    const tileKey& key) const noexcept {
+    std::size_t hash = key.sheet;
+
+    const std::uint64_t parts[] = {
+        static_cast<std::uint64_t>(key.level),
+        static_cast<std::uint64_t>(key.floatType),
+        static_cast<std::uint64_t>(key.x),
+        static_cast<std::uint64_t>(key.y)};
+
+    for (const std::uint64_t part : parts)
+        hash = hash * 0x9E3779B97F4A7C15ull + static_cast<std::size_t>(part);
+
+    return hash ^ (hash >> 29);
+}
+
+void tileCache::m_setBudget(const std::size_t bytes) {
+    m_budget = bytes;
+
+    if (m_budget == 0)
+        m_clear();
+    else
+        m_evict(0);
+}
+
+void tileCache::m_clear() {
+    m_sheets.clear();
+    m_useCount = 0;
+    m_tiles.clear();
+    m_index.clear();
+    m_stats = {};
+}
+
+tileCache::frameLayout tileCache::m_getLayout(
+    const view& v,
+    const int width,
+    const int height) {
+    frameLayout layout;
+
+    // the largest power of two up to the pixel spacing, samples are never
+    // coarser than pixels
+    layout.level =
+        static_cast<int>(
+            std::floor(std::log2(std::min(v.increment.x, v.increment.y))))
+        + v.incrementScale;
+
+    // the center in samples of the first sheet that reaches it
+    double centerX = 0.0, centerY = 0.0;
+    bool bFound = false;
+
+    for (std::size_t i = 0; i < m_sheets.size() && !bFound; ++i) {
+        const sheet& s = m_sheets[i];
+
+        if (!isSameSet(s.set, v))
+            continue;
+
+        centerX =
+            (v.startPos.x - s.anchor.x).m_ldexp(-layout.level).m_toDouble();
+        centerY =
+            (v.startPos.y - s.anchor.y).m_ldexp(-layout.level).m_toDouble();
+
+        if (std::fabs(centerX) < maxSheetOffset
+            && std::fabs(centerY) < maxSheetOffset) {
+            layout.sheet = i;
+            bFound = true;
+        }
+    }
+
+    if (!bFound) {
+        const auto empty =
+            std::find_if(m_sheets.begin(), m_sheets.end(), [](const sheet& s) {
+                return s.tiles == 0;
+            });
+
+        if (empty != m_sheets.end()) {
+            layout.sheet = static_cast<std::size_t>(empty - m_sheets.begin());
+        } else if (m_sheets.size() < maxSheets) {
+            layout.sheet = m_sheets.size();
+            m_sheets.emplace_back();
+        } else {
+            layout.sheet = static_cast<std::size_t>(
+                std::min_element(
+                    m_sheets.begin(),
+                    m_sheets.end(),
+                    [](const sheet& a, const sheet& b) {
+                        return a.lastUse < b.lastUse;
+                    })
+                - m_sheets.begin());
+
+            for (auto it = m_tiles.begin(); it != m_tiles.end();) {
+                const auto next = std::next(it);
+
+                if (it->key.sheet == layout.sheet) {
+                    m_erase(it);
+                    ++m_stats.evictions;
+                }
+
+                it = next;
+            }
+        }
+
+        const int anchorLevel = layout.level + anchorBits;
+
+        const bigVec2 anchor {
+            v.startPos.x.m_ldexp(-anchorLevel).m_floor().m_ldexp(anchorLevel),
+            v.startPos.y.m_ldexp(-anchorLevel).m_floor().m_ldexp(
+                anchorLevel)};
+
+        m_sheets[layout.sheet] = {v, anchor, 0, 0};
+
+        centerX =
+            (v.startPos.x - anchor.x).m_ldexp(-layout.level).m_toDouble();
+        centerY =
+            (v.startPos.y - anchor.y).m_ldexp(-layout.level).m_toDouble();
+    }
+
+    m_sheets[layout.sheet].lastUse = ++m_useCount;
+
+    // pixels per sample, and the steps of GetKernelParams in samples
+    const double incrementX =
+        std::ldexp(v.increment.x, v.incrementScale - layout.level);
+    const double incrementY =
+        std::ldexp(v.increment.y, v.incrementScale - layout.level);
+
+    layout.stepXx = incrementX * v.rotation.x;
+    layout.stepXy = incrementX * v.rotation.y;
+    layout.stepYx = -incrementY * v.rotation.y;
+    layout.stepYy = incrementY * v.rotation.x;
+
+    // the first pixel, with half a sample so floor rounds to the nearest
+    const double offsetX = 0.5 - width / 2;
+    const double offsetY = 0.5 - height / 2;
+
+    layout.originX = centerX + offsetX * layout.stepXx
+        + offsetY * layout.stepYx + 0.5;
+    layout.originY = centerY + offsetX * layout.stepXy
+        + offsetY * layout.stepYy + 0.5;
+
+    // a tile and the rounding past the last pixel, in any rotation
+    layout.margin = static_cast<int>(std::ceil(
+        std::sqrt(2.0) * (tileSize + 1)
+        / std::min(incrementX, incrementY)));
+
+    return layout;
+}
+
+view tileCache::m_getTileView(
+    const view& v,
+    const frameLayout& layout,
+    const std::int64_t x,
+    const std::int64_t y) const {
+    const bigVec2& anchor = m_sheets[layout.sheet].anchor;
+    const std::size_t bits =
+        std::max(anchor.x.m_precision(), v.startPos.x.m_precision());
+
+    // the center of the tile, between its two middle samples
+    const double middle = 0.5 * (tileSize - 1);
+
+    view result = v;
+
+    result.startPos = {
+        anchor.x
+            + bigFloat(static_cast<double>(x) * tileSize + middle, bits)
+                  .m_ldexp(layout.level),
+        anchor.y
+            + bigFloat(static_cast<double>(y) * tileSize + middle, bits)
+                  .m_ldexp(layout.level)};
+
+    const double increment = std::ldexp(1.0, layout.level - v.incrementScale);
+
+    result.increment = {increment, increment};
+    result.rotation = {1.0, 0.0};
+
+    return result;
+}
+
+tileCache::tileData tileCache::m_find(
+    const frameLayout& layout,
+    const precision floatType,
+    const std::int64_t x,
+    const std::int64_t y) {
+    const tileKey key {layout.sheet, layout.level, floatType, x, y};
+
+    if (tileData data = m_get(key)) {
+        ++m_stats.hits;
+        return data;
+    }
+
+    // sample (i, j) of the level is (2 i, 2 j) of the one below, which has
+    // the tile in the four tiles from (2 x, 2 y) on
+    tileData children[4];
+
+    for (std::size_t c = 0; c < 4; ++c) {
+        children[c] = m_get(
+            {layout.sheet,
+             layout.level - 1,
+             floatType,
+             2 * x + static_cast<std::int64_t>(c % 2),
+             2 * y + static_cast<std::int64_t>(c / 2)});
+
+        if (!children[c]) {
+            ++m_stats.misses;
+            return nullptr;
+        }
+    }
+
+    tileData data = std::make_shared<std::vector<int>>(tileSamples);
+
+    for (int j = 0; j < tileSize; ++j) {
+        const int childY = 2 * j / tileSize;
+        const int rowY = 2 * j % tileSize;
+
+        for (int i = 0; i < tileSize; ++i) {
+            const std::vector<int>& child =
+                *children[childY * 2 + 2 * i / tileSize];
+
+            (*data)[static_cast<std::size_t>(j * tileSize + i)] = child
+                [static_cast<std::size_t>(rowY * tileSize + 2 * i % tileSize)];
+        }
+    }
+
+    m_put(key, data);
+    ++m_stats.hits;
+
+    return data;
+}
+
+void tileCache::m_insert(
+    const frameLayout& layout,
+    const precision floatType,
+    const std::int64_t x,
+    const std::int64_t y,
+    tileData data) {
+    if (m_budget > 0)
+        m_put({layout.sheet, layout.level, floatType, x, y}, std::move(data));
+}
+
+tileCache::tileData tileCache::m_get(const tileKey& key) {
+    const auto found = m_index.find(key);
+
+    if (found == m_index.end())
+        return nullptr;
+
+    m_tiles.splice(m_tiles.begin(), m_tiles, found->second);
+
+    return found->second->data;
+}
+
+void tileCache::m_put(const tileKey& key, tileData data) {
+    const auto found = m_index.find(key);
+
+    if (found != m_index.end()) {
+        found->second->data = std::move(data);
+        m_tiles.splice(m_tiles.begin(), m_tiles, found->second);
+        return;
+    }
+
+    m_evict(tileBytes);
+
+    m_tiles.push_front({key, std::move(data)});
+    m_index.emplace(key, m_tiles.begin());
+
+    ++m_sheets[key.sheet].tiles;
+    ++m_stats.tiles;
+    m_stats.bytes += tileBytes;
+}
+
+void tileCache::m_erase(const std::list<tile>::iterator it) {
+    --m_sheets[it->key.sheet].tiles;
+    --m_stats.tiles;
+    m_stats.bytes -= tileBytes;
+
+    m_index.erase(it->key);
+    m_tiles.erase(it);
+}
+
+void tileCache::m_evict(const std::size_t extra) {
+    while (!m_tiles.empty() && m_stats.bytes + extra > m_budget) {
+        m_erase(std::prev(m_tiles.end()));
+        ++m_stats.evictions;
+    }
+}
+
+}  // namespace mandel::core
@@ -0,0 +1,62 @@
+#include "core/view.hpp"
+
+#include <cmath>
+
+namespace mandel::core {
+namespace {
+    // a view moved by whole pixels is off by the rounding of its rotation,
+    // the largest offset is far past any frame size
+    constexpr double pixelTolerance = 1e-6;
+    constexpr double maxPixelOffset = 1 << 30;
+}  // namespace
+
+bool IsSameView(const view& a, const view& b) {
+    if (a.maxIteration != b.maxIteration || a.bUseJuliaSet != b.bUseJuliaSet
+        || a.exponent != b.exponent)
+        return false;
+
+    if (a.bUseJuliaSet
+        && (a.juliaConstant.x != b.juliaConstant.x
+            || a.juliaConstant.y != b.juliaConstant.y))
+        return false;
+
+    return a.increment.x == b.increment.x && a.increment.y == b.increment.y
+        && a.incrementScale == b.incrementScale
+        && a.rotation.x == b.rotation.x && a.rotation.y == b.rotation.y
+        && a.startPos.x == b.startPos.x && a.startPos.y == b.startPos.y;
+}
+
+bool GetPixelOffset(const view& a, const view& b, int& offsetX, int& offsetY) {
+    view moved = a;
+    moved.startPos = b.startPos;
+
+    if (!IsSameView(moved, b))
+        return false;
+
+    // the move in pixels, the center moved by it rotated
+    const double moveX =
+        (b.startPos.x - a.startPos.x).m_ldexp(-a.incrementScale).m_toDouble();
+    const double moveY =
+        (b.startPos.y - a.startPos.y).m_ldexp(-a.incrementScale).m_toDouble();
+
+    const double x =
+        (moveX * a.rotation.x + moveY * a.rotation.y) / a.increment.x;
+    const double y =
+        (moveY * a.rotation.x - moveX * a.rotation.y) / a.increment.y;
+
+    const double roundedX = std::round(x);
+    const double roundedY = std::round(y);
+
+    if (std::fabs(x - roundedX) > pixelTolerance
+        || std::fabs(y - roundedY) > pixelTolerance
+        || std::fabs(roundedX) > maxPixelOffset
+        || std::fabs(roundedY) > maxPixelOffset)
+        return false;
+
+    offsetX = static_cast<int>(roundedX);
+    offsetY = static_cast<int>(roundedY);
+
+    return true;
+}
+
+}  // namespace mandel::core
@@ -1,8 +1,15 @@
 #include "mandel.hpp"
 
+#include <algorithm>
+#include <iterator>
+#include <thread>
+#include <vector>
+
 #include "buffer_object.hpp"
+#include "core/renderer.hpp"
 #include "mandel_handler.hpp"
 #include "shader.hpp"
+#include "texture.hpp"
 #include "uniform.hpp"
 #include "utility.hpp"
 #include "vertex_array_object.hpp"
@@ -97,6 +104,216 @@ namespace {
         }
     }
 
+    // frames rendered by mandel_core instead of fragment.glsl
+    bool bUseCpuRenderer = false;
+
+    // frames past what the float shader resolves go to mandel_core as well
+    bool bCpuFrame = false;
+    core::precisionChoice frameTier;
+
+    gl::shader textureShader;
+    gl::texture frameTexture;
+
+    core::renderer cpuRenderer;
+
+    // colors of the frame the renderer keeps and the palette they are for
+    std::vector<std::uint8_t> framePixels;
+    core::palette framePalette;
+
+    bool isSamePalette(const core::palette& a, const core::palette& b) {
+        return std::equal(
+                   std::begin(a.colorPalette),
+                   std::end(a.colorPalette),
+                   std::begin(b.colorPalette))
+            && a.colorPeriod == b.colorPeriod;
+    }
+
+    // unchanged frames are not rendered again and only colored again when
+    // the palette changed
+    void renderCpuFrame() {
+        const vec4<int> screenSize = uScreenSize.vec();
+        const std::size_t count = static_cast<std::size_t>(screenSize.x)
+            * static_cast<std::size_t>(screenSize.y);
+
+        const core::view view = GetMandelView();
+        const core::palette palette = GetMandelPalette();
+
+        const bool bRendered =
+            cpuRenderer.m_update(view, screenSize.x, screenSize.y);
+
+        if (!bRendered && isSamePalette(palette, framePalette))
+            return;
+
+        framePixels.resize(count * 4);
+
+        core::ColorIterations(
+            palette,
+            view.maxIteration,
+            cpuRenderer.frame().data(),
+            count,
+            framePixels.data());
+
+        framePalette = palette;
+
+        frameTexture.m_setData(screenSize.x, screenSize.y, framePixels.data());
+    }
+
+    const char* getPrecisionName(const core::precision floatType) {
+        static const char* names[] = {
+            "Float",
+            "Double",
+            "Double-Double",
+            "Perturbation"};
+
+        return names[static_cast<std::size_t>(floatType)];
+    }
+
+    // picks the tier of the next frame, the shader only draws float ones
+    void updateFrameTier() {
+        const core::renderOptions& options = cpuRenderer.options();
+
+        if (options.bAutoPrecision) {
+            frameTier = core::SelectPrecision(
+                GetMandelView(),
+                uScreenSize.vec().x,
+                uScreenSize.vec().y);
+        } else {
+            frameTier = {options.floatType, "set in the options"};
+        }
+
+        bCpuFrame = bUseCpuRenderer
+            || frameTier.floatType != core::precision::singleFloat;
+    }
+
+    void DrawCpuRenderer_ImGui() {
+        ImGui::Checkbox("CPU Renderer", &bUseCpuRenderer);
+
+        core::renderOptions options = cpuRenderer.options();
+
+        static const char* precisionNames[] = {
+            "Auto",
+            "Float",
+            "Double",
+            "Double-Double",
+            "Perturbation"};
+
+        // auto is the first entry
+        int floatType = options.bAutoPrecision
+            ? 0
+            : static_cast<int>(options.floatType) + 1;
+
+        if (ImGui::Combo("Precision", &floatType, precisionNames, 5)) {
+            options.bAutoPrecision = floatType == 0;
+
+            if (!options.bAutoPrecision)
+                options.floatType = static_cast<core::precision>(floatType - 1);
+        }
+
+        if (!bCpuFrame) {
+            cpuRenderer.setOptions(options);
+
+            ImGui::Text(
+                "Tier: %s (%s), shader",
+                getPrecisionName(frameTier.floatType),
+                frameTier.reason);
+            return;
+        }
+
+        const int hardwareThreads =
+            std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+        if (options.threadCount == 0)
+            options.threadCount = hardwareThreads;
+
+        ImGui::SliderInt("Threads", &options.threadCount, 1, hardwareThreads);
+        ImGui::SliderInt("Tile Size", &options.tileSize, 8, 256);
+        ImGui::Checkbox("BLA", &options.bUseBla);
+        ImGui::SliderInt("Series Terms", &options.seriesTerms, 0, 32);
+        ImGui::Checkbox("Glitch Detection", &options.bDetectGlitches);
+
+        static const char* fillNames[] = {
+            "Every Pixel",
+            "Subdivide",
+            "Boundary Trace"};
+
+        int fill = static_cast<int>(options.fill);
+
+        if (ImGui::Combo("Fill", &fill, fillNames, 3))
+            options.fill = static_cast<core::fillMode>(fill);
+
+        ImGui::Checkbox("Verify Fill", &options.bVerifyFill);
+
+        int tileCacheMegabytes =
+            static_cast<int>(options.tileCacheBudget >> 20);
+
+        if (ImGui::SliderInt("Tile Cache MB", &tileCacheMegabytes, 0, 2048)) {
+            options.tileCacheBudget =
+                static_cast<std::size_t>(tileCacheMegabytes) << 20;
+        }
+
+        cpuRenderer.setOptions(options);
+
+        const core::frameStats& stats = cpuRenderer.stats();
+
+        ImGui::Text(
+            "Tier: %s (%s)",
+            getPrecisionName(stats.tier.floatType),
+            stats.tier.reason);
+        ImGui::Text(
+            "CPU render time: %.3f ms (%s)%s",
+            stats.renderTime,
+            stats.kernelName,
+            stats.bKept ? ", kept" : "");
+        ImGui::Text(
+            "Tiles: %zu, stolen: %zu, threads: %zu",
+            stats.tileCount,
+            stats.stolenTiles,
+            stats.threadCount);
+        ImGui::Text(
+            "Periodic pixels: %zu (%.1f%%)",
+            stats.periodicPixels,
+            stats.periodicFraction * 100.0);
+        ImGui::Text(
+            "Computed pixels: %zu, resumed: %zu",
+            stats.computedPixels,
+            stats.resumedPixels);
+
+        if (stats.panX != 0 || stats.panY != 0)
+            ImGui::Text("Panned by %d, %d pixels", stats.panX, stats.panY);
+
+        if (options.bVerifyFill && options.fill != core::fillMode::everyPixel)
+            ImGui::Text("Fill mismatches: %zu", stats.fillMismatches);
+
+        if (options.tileCacheBudget != 0) {
+            ImGui::Text(
+                "Tile cache: %zu hits, %zu misses, %zu evictions, %.1f MB",
+                stats.cache.hits,
+                stats.cache.misses,
+                stats.cache.evictions,
+                static_cast<double>(stats.cache.bytes) / (1 << 20));
+        }
+
+        if (stats.referenceLength != 0) {
+            static const char* sourceNames[] = {"computed", "reused", "loaded"};
+
+            ImGui::Text(
+                "Reference orbit: %zu iterations in %.3f ms (%s), %zu BLA "
+                "levels",
+                stats.referenceLength,
+                stats.referenceTime,
+                sourceNames[static_cast<std::size_t>(stats.referenceSource)],
+                stats.blaLevels);
+            ImGui::Text("Series skip: %zu iterations", stats.seriesSkip);
+
+            if (options.bDetectGlitches) {
+                ImGui::Text(
+                    "Glitched pixels: %zu, extra references: %zu",
+                    stats.glitches.glitchedPixels,
+                    stats.glitches.references);
+            }
+        }
+    }
+
     void DrawImGui() {
         static bool fpsLock = true;
 
@@ -104,6 +321,8 @@ namespace {
 
         DrawUniforms_ImGui(uScreenSize.vec());
 
+        DrawCpuRenderer_ImGui();
+
         if (ImGui::Checkbox("FPS Lock", &fpsLock))
             glfwSwapInterval(static_cast<int>(fpsLock));
 
@@ -151,6 +370,22 @@ bool Init() {
         shader.m_createShaders("res/vertex.glsl", "res/fragment.glsl"),
         "cannot create shaders");
 
+    ASSERT(
+        textureShader.m_createShaders("res/vertex.glsl", "res/texture.glsl"),
+        "cannot create shaders");
+
+    frameTexture.m_create();
+
+    {
+        core::renderOptions options = cpuRenderer.options();
+        options.bAutoPrecision = true;
+        // next to res, deep zooms revisited in a later run skip their
+        // reference orbits, the least recently used go past 256 MB
+        options.orbitCacheDirectory = "orbit_cache";
+
+        cpuRenderer.setOptions(options);
+    }
+
     shader.m_bind();
 
     CreateMandelUniforms(shader);
@@ -209,9 +444,21 @@ void Run() {
             ImGui::NewFrame();
 
             //rendering
+            updateFrameTier();
+
+            if (bCpuFrame) {
+                renderCpuFrame();
+
+                textureShader.m_bind();
+                frameTexture.m_bind();
+            }
+
             GLCALL(
                 glDrawElements(GL_TRIANGLES, 3 * 2, GL_UNSIGNED_INT, nullptr));
 
+            // the uniforms are updated on the mandel shader
+            shader.m_bind();
+
             DrawImGui();
 
             //render present
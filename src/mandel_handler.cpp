@@ -1,5 +1,6 @@
 #include "mandel_handler.hpp"
 
+#include "core/camera.hpp"
 #include "uniform.hpp"
 
 namespace mandel {
@@ -20,44 +21,20 @@ namespace {
 
     auto colorPalette = gl::s_getUniformArray<9, float>(glUniform3fv);
 
-    float angle;
-
-    // rotate a vector by rotation
-    vec4<float> getRotated(vec4<float> vec) {
-        const float oldX = vec.x;
-
-        vec.x = vec.x * rotation.vec().x - vec.y * rotation.vec().y;
-        vec.y = oldX * rotation.vec().y + vec.y * rotation.vec().x;
-
-        return vec;
-    }
-
-    // turn screen location to complex plane location
-    vec4<float>
-    getWorldLocation(vec4<float> pos, const vec4<float> screenSize) {
-        return startPos.vec()
-            + getRotated((pos - screenSize / 2) * increment.vec());
-    }
-
-    void updateIncrement(
-        const vec4<float> worldSpace,
-        const vec4<float> screenSize) {
-        vec4<float> inc {worldSpace / screenSize};
-
-        if (inc.x > inc.y)
-            inc.y = inc.x;
-        else
-            inc.x = inc.y;
-
-        increment.setVec(inc);
-    }
+    // exact location and zoom, the uniforms above only get a float
+    // projection of it
+    core::camera camera;
 
     constexpr float PI = 3.14159265359f;
 
-    void setRotationVec(const float newAngle) {
-        angle = newAngle;
+    void updateCameraUniforms() {
+        const vec4<double> pos = camera.m_getStartPos();
+        const auto inc = static_cast<float>(camera.m_getIncrement());
 
-        rotation.setVec({std::cos(angle), std::sin(angle)});
+        startPos.setVec(
+            {static_cast<float>(pos.x), static_cast<float>(pos.y)});
+        increment.setVec({inc, inc});
+        rotation.setVec(camera.rotation());
     }
 }  // namespace
 
@@ -76,17 +53,16 @@ void CreateMandelUniforms(const gl::shader& shader) {
 void UpdateScreenSize(
     const vec4<float> oldScreenSize,
     const vec4<float> newScreenSize) {
-    updateIncrement(increment.vec() * oldScreenSize, newScreenSize);
+    camera.m_resize(oldScreenSize, newScreenSize);
+
+    updateCameraUniforms();
 }
 
 void ResetMandel(const vec4<float> screenSize) {
-    startPos.setVec({0.0f, 0.0f});
-    rotation.setVec({1.0f, 0.0f});  // (cos0, sin0)
-    maxIteration.setVec(100);
-
-    updateIncrement({4.0f, 4.0f}, screenSize);
+    camera.m_reset({4.0, 4.0}, screenSize);
+    updateCameraUniforms();
 
-    angle = 0.0f;
+    maxIteration.setVec(100);
 
     colorPalette.setVec({1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f});
 
@@ -99,27 +75,22 @@ void ResetMandel(const vec4<float> screenSize) {
 
 // move the set by changing offset
 void MoveMandel(const vec4<float> movement) {
-    startPos.setVec(startPos.vec() - getRotated(movement * increment.vec()));
+    camera.m_move(movement);
+
+    updateCameraUniforms();
 }
 
 void ZoomMandel(
     const float zoomFactor,
     vec4<float> mousePos,
     const vec4<float> screenSize) {
-    // mouse world location before the zoom
-    const vec4<float> beforeZoom = getWorldLocation(mousePos, screenSize);
-
-    // zoom
-    increment.setVec(increment.vec() * zoomFactor);
+    camera.m_zoom(zoomFactor, mousePos, screenSize);
 
-    // after the zoom location
-    const vec4<float> afterZoom = getWorldLocation(mousePos, screenSize);
-
-    // subtract the difference from the offset
-    startPos.setVec(startPos.vec() - (afterZoom - beforeZoom));
+    updateCameraUniforms();
 }
 
 void DrawUniforms_ImGui(const vec4<int> screenSize) {
+    const auto angle = static_cast<float>(camera.angle());
     float newAngle = angle;
 
     int newMaxIteration = maxIteration.vec().x;
@@ -161,8 +132,10 @@ void DrawUniforms_ImGui(const vec4<int> screenSize) {
     if (ImGui::Checkbox("Julia Set", &useJuliaSet))
         bUseJuliaSet.setVec(useJuliaSet);
 
-    if (newAngle != angle)
-        setRotationVec(newAngle);
+    if (newAngle != angle) {
+        camera.m_setAngle(newAngle);
+        updateCameraUniforms();
+    }
 
     maxIteration.setVec(newMaxIteration);
     colorPalette.m_update();
@@ -182,4 +155,27 @@ void DrawUniforms_ImGui(const vec4<int> screenSize) {
         juliaConstant.m_update();
     }
 }
+
+core::view GetMandelView() {
+    core::view v;
+
+    camera.m_apply(v);
+    v.maxIteration = maxIteration.vec().x;
+
+    v.bUseJuliaSet = bUseJuliaSet.vec().x;
+    v.juliaConstant = juliaConstant.vec();
+
+    v.exponent = exponent.vec().x;
+
+    return v;
+}
+
+core::palette GetMandelPalette() {
+    core::palette p;
+
+    std::memcpy(p.colorPalette, colorPalette.vec(), sizeof(p.colorPalette));
+    p.colorPeriod = colorPeriod.vec().x;
+
+    return p;
+}
 }  // namespace mandel
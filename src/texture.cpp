@@ -0,0 +1,63 @@
+#include "texture.hpp"
+
+namespace mandel::gl {
+
+texture::texture() {}
+
+texture::~texture() {
+    GLCALL(glDeleteTextures(1, &m_id));
+}
+
+void texture::m_create() {
+    GLCALL(glGenTextures(1, &m_id));
+
+    m_bind();
+    GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+    GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+    GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    m_unbind();
+}
+
+void texture::m_bind() const {
+    GLCALL(glBindTexture(GL_TEXTURE_2D, m_id));
+}
+void texture::m_unbind() const {
+    GLCALL(glBindTexture(GL_TEXTURE_2D, 0));
+}
+
+void texture::m_setData(
+    const int width,
+    const int height,
+    const std::uint8_t* rgba) {
+    m_bind();
+
+    if (width != m_width || height != m_height) {
+        m_width = width;
+        m_height = height;
+
+        GLCALL(glTexImage2D(
+            GL_TEXTURE_2D,
+            0,
+            GL_RGBA8,
+            width,
+            height,
+            0,
+            GL_RGBA,
+            GL_UNSIGNED_BYTE,
+            rgba));
+    } else {
+        GLCALL(glTexSubImage2D(
+            GL_TEXTURE_2D,
+            0,
+            0,
+            0,
+            width,
+            height,
+            GL_RGBA,
+            GL_UNSIGNED_BYTE,
+            rgba));
+    }
+}
+
+}  // namespace mandel::gl
@@ -0,0 +1,103 @@
+// renders a few views with fillMode::boundaryTrace and pixel by pixel and
+// fails when any pixel differs or boundary tracing computes more of them
+// than the view allows
+//
+// usage: fill_test
+
+#include <cstddef>
+#include <cstdio>
+#include <iterator>
+#include <vector>
+
+#include "core/renderer.hpp"
+
+namespace {
+using namespace mandel::core;
+
+struct testView {
+    const char* name;
+    bool bUseJuliaSet;
+    double centerX, centerY;
+    double juliaX, juliaY;
+    // of the complex plane across the frame
+    double width;
+    // share of the pixels boundary tracing may compute, the wide views
+    // with big bands and sets need the fewest
+    double maxComputed;
+};
+
+constexpr testView testViews[] = {
+    {"mandelbrot", false, -0.5, 0.0, 0.0, 0.0, 3.0, 0.4},
+    {"bulbs", false, -0.16, 0.85, 0.0, 0.0, 0.3, 0.6},
+    {"seahorse valley", false, -0.745, 0.11, 0.0, 0.0, 0.02, 0.5},
+    {"minibrot", false, -1.7687, 0.0017, 0.0, 0.0, 0.002, 0.85},
+    {"rabbit", true, 0.0, 0.0, -0.123, 0.745, 3.0, 0.4},
+    {"dendrite", true, 0.0, 0.0, -0.8, 0.156, 3.0, 0.65}};
+
+constexpr precision testPrecisions[] = {
+    precision::singleFloat,
+    precision::doubleFloat};
+
+constexpr const char* precisionNames[] = {"float", "double"};
+
+constexpr int frameWidth = 640;
+constexpr int frameHeight = 360;
+}  // namespace
+
+int main() {
+    const std::size_t count = static_cast<std::size_t>(frameWidth)
+        * static_cast<std::size_t>(frameHeight);
+
+    std::vector<int> expected(count);
+    std::vector<int> traced(count);
+
+    int failures = 0;
+
+    for (const testView& test : testViews) {
+        view v;
+        v.maxIteration = 2000;
+        v.bUseJuliaSet = test.bUseJuliaSet;
+        v.juliaConstant = {test.juliaX, test.juliaY};
+        v.startPos = {test.centerX, test.centerY};
+        v.increment = {test.width / frameWidth, test.width / frameWidth};
+
+        for (std::size_t i = 0; i < std::size(testPrecisions); ++i) {
+            renderOptions options;
+            options.floatType = testPrecisions[i];
+
+            renderer everyPixel(options);
+            everyPixel.m_render(v, frameWidth, frameHeight, expected.data());
+
+            options.fill = fillMode::boundaryTrace;
+
+            renderer boundaryTrace(options);
+            boundaryTrace.m_render(v, frameWidth, frameHeight, traced.data());
+
+            std::size_t mismatches = 0;
+
+            for (std::size_t pixel = 0; pixel < count; ++pixel) {
+                if (traced[pixel] != expected[pixel])
+                    ++mismatches;
+            }
+
+            const std::size_t computed = boundaryTrace.stats().computedPixels;
+            const std::size_t maxComputed = static_cast<std::size_t>(
+                test.maxComputed * static_cast<double>(count));
+
+            std::printf(
+                "%-16s %-7s %zu of %zu pixels computed, at most %zu, %zu "
+                "mismatches\n",
+                test.name,
+                precisionNames[i],
+                computed,
+                count,
+                maxComputed,
+                mismatches);
+
+            if (mismatches != 0 || computed > maxComputed)
+                ++failures;
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,203 @@
+// keeps a frame of renderer across palette changes and whole pixel pans and
+// fails when a kept frame is rendered again, its colors differ from a frame
+// colored anew or a moved frame differs from the one rendered anew
+//
+// usage: renderer_test
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <vector>
+
+#include "core/renderer.hpp"
+
+namespace {
+using namespace mandel::core;
+
+struct testView {
+    const char* name;
+    double centerX, centerY;
+    // of the complex plane across the frame
+    double width;
+    // radians
+    double angle;
+};
+
+constexpr testView testViews[] = {
+    {"seahorse valley", -0.745, 0.11, 0.02, 0.0},
+    {"seahorse rotated", -0.745, 0.11, 0.02, 0.7}};
+
+constexpr fillMode testFills[] = {
+    fillMode::everyPixel,
+    fillMode::subdivide,
+    fillMode::boundaryTrace};
+
+constexpr const char* fillNames[] = {"every pixel", "subdivide", "trace"};
+
+constexpr precision testPrecisions[] = {
+    precision::singleFloat,
+    precision::doubleFloat,
+    precision::doubleDouble};
+
+constexpr const char* precisionNames[] = {"float", "double", "dd"};
+
+// whole pixels every pan moves the view by, one after the other
+constexpr int testPans[][2] = {{40, 0}, {0, -25}, {-33, 17}, {1, 1}};
+
+constexpr int frameWidth = 640;
+constexpr int frameHeight = 360;
+
+constexpr std::size_t frameCount =
+    static_cast<std::size_t>(frameWidth) * frameHeight;
+
+template <typename T>
+std::size_t countMismatches(const std::vector<T>& a, const std::vector<T>& b) {
+    std::size_t mismatches = 0;
+
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (a[i] != b[i])
+            ++mismatches;
+    }
+
+    return mismatches;
+}
+
+// v with its center moved by x and y pixels along its rotated axes
+view movePixels(const view& v, const int x, const int y) {
+    const double moveX = x * v.increment.x * v.rotation.x
+        - y * v.increment.y * v.rotation.y;
+    const double moveY = x * v.increment.x * v.rotation.y
+        + y * v.increment.y * v.rotation.x;
+
+    view moved = v;
+    moved.startPos = {
+        v.startPos.x + bigFloat(moveX),
+        v.startPos.y + bigFloat(moveY)};
+
+    return moved;
+}
+
+// a palette change keeps the frame and only colors it again, which gives
+// the colors of Render
+int checkRecolor(const view& v) {
+    int failures = 0;
+
+    renderer kept;
+
+    const bool bFirst = kept.m_update(v, frameWidth, frameHeight);
+    const std::vector<int> first = kept.frame();
+
+    palette palettes[2];
+    palettes[1].colorPeriod = 0.37f;
+    palettes[1].colorPalette[0] = 0.2f;
+    palettes[1].colorPalette[4] = 0.9f;
+
+    for (std::size_t p = 0; p < std::size(palettes); ++p) {
+        const bool bRendered = kept.m_update(v, frameWidth, frameHeight);
+
+        std::vector<std::uint8_t> recolored(frameCount * 4);
+        std::vector<std::uint8_t> rendered(frameCount * 4);
+
+        ColorIterations(
+            palettes[p],
+            v.maxIteration,
+            kept.frame().data(),
+            frameCount,
+            recolored.data());
+
+        Render(v, palettes[p], frameWidth, frameHeight, rendered.data());
+
+        const std::size_t mismatches = countMismatches(recolored, rendered);
+
+        std::printf(
+            "recolor %zu: %s, %zu of %zu bytes differ from Render\n",
+            p,
+            bRendered ? "rendered again" : "kept",
+            mismatches,
+            recolored.size());
+
+        if (!bFirst || bRendered || !kept.stats().bKept
+            || countMismatches(first, kept.frame()) != 0 || mismatches != 0)
+            ++failures;
+    }
+
+    // an option that changes the iterations renders the frame again
+    renderOptions options;
+    options.floatType = precision::singleFloat;
+    kept.setOptions(options);
+
+    const bool bRendered = kept.m_update(v, frameWidth, frameHeight);
+
+    std::printf(
+        "recolor after a precision change: %s\n",
+        bRendered ? "rendered again" : "kept");
+
+    if (!bRendered || kept.stats().bKept)
+        ++failures;
+
+    return failures;
+}
+}  // namespace
+
+int main() {
+    int failures = 0;
+
+    for (const testView& test : testViews) {
+        view v;
+        v.maxIteration = 1000;
+        v.startPos = {test.centerX, test.centerY};
+        v.increment = {test.width / frameWidth, test.width / frameWidth};
+        v.rotation = {std::cos(test.angle), std::sin(test.angle)};
+
+        std::printf("%s\n", test.name);
+
+        failures += checkRecolor(v);
+
+        for (std::size_t f = 0; f < std::size(testFills); ++f) {
+            for (std::size_t i = 0; i < std::size(testPrecisions); ++i) {
+                renderOptions options;
+                options.floatType = testPrecisions[i];
+                options.fill = testFills[f];
+
+                renderer panned(options);
+                panned.m_update(v, frameWidth, frameHeight);
+
+                view moved = v;
+
+                for (const auto& pan : testPans) {
+                    moved = movePixels(moved, pan[0], pan[1]);
+                    panned.m_update(moved, frameWidth, frameHeight);
+
+                    renderer fresh(options);
+                    fresh.m_update(moved, frameWidth, frameHeight);
+
+                    const frameStats& stats = panned.stats();
+                    const std::size_t mismatches =
+                        countMismatches(panned.frame(), fresh.frame());
+
+                    std::printf(
+                        "pan %-11s %-6s by %3d %3d, %6zu pixels computed, "
+                        "%zu mismatches\n",
+                        fillNames[f],
+                        precisionNames[i],
+                        stats.panX,
+                        stats.panY,
+                        stats.computedPixels,
+                        mismatches);
+
+                    // subdivide renders every frame anew
+                    const bool bMoved = testFills[f] != fillMode::subdivide;
+
+                    if (stats.panX != (bMoved ? pan[0] : 0)
+                        || stats.panY != (bMoved ? pan[1] : 0)
+                        || mismatches != 0)
+                        ++failures;
+                }
+            }
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+// raises the maxIteration of a few kept frames in every fill mode and fails
+// when a pixel differs from the frame rendered anew
+//
+// usage: resume_test
+
+#include <cstddef>
+#include <cstdio>
+#include <iterator>
+#include <vector>
+
+#include "core/renderer.hpp"
+
+namespace {
+using namespace mandel::core;
+
+struct testView {
+    const char* name;
+    bool bUseJuliaSet;
+    double centerX, centerY;
+    double juliaX, juliaY;
+    // of the complex plane across the frame
+    double width;
+};
+
+constexpr testView testViews[] = {
+    {"mandelbrot", false, -0.5, 0.0, 0.0, 0.0, 3.0},
+    {"seahorse valley", false, -0.745, 0.11, 0.0, 0.0, 0.02},
+    {"minibrot", false, -1.7687, 0.0017, 0.0, 0.0, 0.002},
+    {"rabbit", true, 0.0, 0.0, -0.123, 0.745, 3.0}};
+
+constexpr fillMode testFills[] = {
+    fillMode::everyPixel,
+    fillMode::subdivide,
+    fillMode::boundaryTrace};
+
+constexpr const char* fillNames[] = {"every pixel", "subdivide", "trace"};
+
+constexpr precision testPrecisions[] = {
+    precision::singleFloat,
+    precision::doubleFloat};
+
+constexpr const char* precisionNames[] = {"float", "double"};
+
+constexpr int frameWidth = 640;
+constexpr int frameHeight = 360;
+
+constexpr int firstMaxIteration = 50;
+constexpr int raisedMaxIteration = 2000;
+}  // namespace
+
+int main() {
+    const std::size_t count = static_cast<std::size_t>(frameWidth)
+        * static_cast<std::size_t>(frameHeight);
+
+    int failures = 0;
+
+    for (const testView& test : testViews) {
+        view v;
+        v.maxIteration = firstMaxIteration;
+        v.bUseJuliaSet = test.bUseJuliaSet;
+        v.juliaConstant = {test.juliaX, test.juliaY};
+        v.startPos = {test.centerX, test.centerY};
+        v.increment = {test.width / frameWidth, test.width / frameWidth};
+
+        view raised = v;
+        raised.maxIteration = raisedMaxIteration;
+
+        for (std::size_t f = 0; f < std::size(testFills); ++f) {
+            for (std::size_t i = 0; i < std::size(testPrecisions); ++i) {
+                renderOptions options;
+                options.floatType = testPrecisions[i];
+                options.fill = testFills[f];
+
+                renderer resumed(options);
+                resumed.m_update(v, frameWidth, frameHeight);
+                resumed.m_update(raised, frameWidth, frameHeight);
+
+                renderer fresh(options);
+                fresh.m_update(raised, frameWidth, frameHeight);
+
+                std::size_t mismatches = 0;
+
+                for (std::size_t pixel = 0; pixel < count; ++pixel) {
+                    if (resumed.frame()[pixel] != fresh.frame()[pixel])
+                        ++mismatches;
+                }
+
+                std::printf(
+                    "%-16s %-11s %-7s %zu pixels resumed, %zu mismatches\n",
+                    test.name,
+                    fillNames[f],
+                    precisionNames[i],
+                    resumed.stats().resumedPixels,
+                    mismatches);
+
+                if (mismatches != 0)
+                    ++failures;
+            }
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
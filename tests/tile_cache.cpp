@@ -0,0 +1,252 @@
+// renders a few views through the tile cache of renderer, coming back to
+// them, zooming out to the next level and past a small budget, and fails
+// when the hits, misses or evictions are not the ones expected or a pixel
+// is not the iteration count of its sample
+//
+// the samples are checked against their tiles rendered directly, and the
+// pixels a frame gets wrong against a frame rendered pixel by pixel may be
+// at most the ones a frame moved by half a pixel gets wrong
+//
+// usage: tile_cache_test
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "core/renderer.hpp"
+
+namespace {
+using namespace mandel::core;
+
+struct testView {
+    const char* name;
+    bool bUseJuliaSet;
+    double centerX, centerY;
+    double juliaX, juliaY;
+    // of the complex plane across the frame
+    double width;
+    // radians
+    double angle;
+};
+
+constexpr testView testViews[] = {
+    {"seahorse valley", false, -0.745, 0.11, 0.0, 0.0, 0.02, 0.0},
+    {"seahorse rotated", false, -0.745, 0.11, 0.0, 0.0, 0.02, 0.7},
+    {"rabbit", true, 0.0, 0.0, -0.123, 0.745, 3.0, 0.3}};
+
+constexpr precision testPrecisions[] = {
+    precision::singleFloat,
+    precision::doubleFloat};
+
+constexpr const char* precisionNames[] = {"float", "double"};
+
+constexpr int frameWidth = 640;
+constexpr int frameHeight = 360;
+
+constexpr std::size_t frameCount =
+    static_cast<std::size_t>(frameWidth) * frameHeight;
+
+constexpr std::size_t largeBudget = std::size_t {64} << 20;
+constexpr std::size_t smallBudget = std::size_t {1} << 20;
+
+std::size_t countMismatches(const int* a, const int* b) {
+    std::size_t mismatches = 0;
+
+    for (std::size_t pixel = 0; pixel < frameCount; ++pixel) {
+        if (a[pixel] != b[pixel])
+            ++mismatches;
+    }
+
+    return mismatches;
+}
+
+// pixels whose sample differs from it rendered directly
+std::size_t checkSamples(
+    const renderOptions& options,
+    const std::vector<int>& frame,
+    const view& v,
+    tileCache& mirror) {
+    const tileCache::frameLayout layout =
+        mirror.m_getLayout(v, frameWidth, frameHeight);
+
+    constexpr int size = tileCache::tileSize;
+
+    renderOptions direct = options;
+    direct.tileCacheBudget = 0;
+
+    std::map<std::pair<std::int64_t, std::int64_t>, std::vector<int>> tiles;
+    std::size_t mismatches = 0;
+
+    for (int y = 0; y < frameHeight; ++y) {
+        for (int x = 0; x < frameWidth; ++x) {
+            std::int64_t i, j;
+            layout.m_getSample(x, y, i, j);
+
+            const std::int64_t tx = (i >= 0 ? i : i - size + 1) / size;
+            const std::int64_t ty = (j >= 0 ? j : j - size + 1) / size;
+
+            std::vector<int>& tile = tiles[{tx, ty}];
+
+            if (tile.empty()) {
+                tile.resize(static_cast<std::size_t>(size * size));
+
+                RenderIterations(
+                    mirror.m_getTileView(v, layout, tx, ty),
+                    size,
+                    size,
+                    tile.data(),
+                    direct);
+            }
+
+            const std::size_t sample = static_cast<std::size_t>(
+                (j - ty * size) * size + i - tx * size);
+            const std::size_t pixel =
+                static_cast<std::size_t>(y) * frameWidth
+                + static_cast<std::size_t>(x);
+
+            if (tile[sample] != frame[pixel])
+                ++mismatches;
+        }
+    }
+
+    return mismatches;
+}
+
+// the pixels the frame gets wrong against one rendered pixel by pixel, and
+// the ones a frame moved by half a pixel on both axes gets wrong
+void getBound(
+    const renderOptions& options,
+    const std::vector<int>& frame,
+    const view& v,
+    std::size_t& mismatches,
+    std::size_t& bound) {
+    std::vector<int> exact(frameCount);
+    std::vector<int> moved(frameCount);
+
+    RenderIterations(v, frameWidth, frameHeight, exact.data(), options);
+
+    view half = v;
+    const double moveX = 0.5 * (v.increment.x * v.rotation.x
+                                - v.increment.y * v.rotation.y);
+    const double moveY = 0.5 * (v.increment.x * v.rotation.y
+                                + v.increment.y * v.rotation.x);
+    half.startPos = {
+        v.startPos.x + bigFloat(moveX),
+        v.startPos.y + bigFloat(moveY)};
+
+    RenderIterations(half, frameWidth, frameHeight, moved.data(), options);
+
+    mismatches = countMismatches(frame.data(), exact.data());
+    bound = countMismatches(moved.data(), exact.data());
+}
+}  // namespace
+
+int main() {
+    int failures = 0;
+
+    const auto check = [&](const bool bPassed, const char* what) {
+        if (!bPassed) {
+            std::printf("  failed: %s\n", what);
+            ++failures;
+        }
+    };
+
+    for (const testView& test : testViews) {
+        view v;
+        v.maxIteration = 1000;
+        v.bUseJuliaSet = test.bUseJuliaSet;
+        v.juliaConstant = {test.juliaX, test.juliaY};
+        v.startPos = {test.centerX, test.centerY};
+        v.increment = {test.width / frameWidth, test.width / frameWidth};
+        v.rotation = {std::cos(test.angle), std::sin(test.angle)};
+
+        // a frame width away, on the same sheet
+        view far = v;
+        far.startPos.x = v.startPos.x + bigFloat(test.width);
+
+        // twice the spacing is the level above, its tiles are put together
+        // from the ones of v where they have all four
+        view out = v;
+        out.increment = {2.0 * v.increment.x, 2.0 * v.increment.y};
+
+        for (std::size_t p = 0; p < std::size(testPrecisions); ++p) {
+            renderOptions options;
+            options.floatType = testPrecisions[p];
+            options.tileCacheBudget = largeBudget;
+
+            renderer cached(options);
+            tileCache mirror;
+            mirror.m_setBudget(largeBudget);
+
+            std::printf("%s %s\n", test.name, precisionNames[p]);
+
+            const auto render = [&](const char* name, const view& frame) {
+                const tileCacheStats before = cached.stats().cache;
+
+                cached.m_update(frame, frameWidth, frameHeight);
+
+                const tileCacheStats& after = cached.stats().cache;
+
+                std::size_t mismatches, bound;
+                getBound(options, cached.frame(), frame, mismatches, bound);
+
+                const std::size_t samples =
+                    checkSamples(options, cached.frame(), frame, mirror);
+
+                std::printf(
+                    "  %-6s %4zu hits %4zu misses %4zu evictions %5zu kB, "
+                    "%zu sample mismatches, %zu of at most %zu pixels off\n",
+                    name,
+                    after.hits - before.hits,
+                    after.misses - before.misses,
+                    after.evictions - before.evictions,
+                    after.bytes >> 10,
+                    samples,
+                    mismatches,
+                    bound);
+
+                check(samples == 0, "pixels are their samples");
+                check(mismatches <= bound, "within half a pixel");
+                check(after.bytes <= options.tileCacheBudget, "budget");
+
+                return std::make_pair(before, after);
+            };
+
+            auto [before, after] = render("first", v);
+            check(after.hits == 0 && after.misses > 0, "first frame misses");
+
+            const std::vector<int> first = cached.frame();
+
+            render("far", far);
+
+            std::tie(before, after) = render("back", v);
+            check(
+                after.misses == before.misses && after.hits > before.hits,
+                "coming back hits");
+            check(
+                countMismatches(first.data(), cached.frame().data()) == 0,
+                "coming back gives the first frame");
+
+            std::tie(before, after) = render("out", out);
+            check(after.hits > before.hits, "zooming out puts tiles together");
+
+            options.tileCacheBudget = smallBudget;
+            cached.setOptions(options);
+            mirror.m_setBudget(smallBudget);
+
+            render("small", far);
+
+            std::tie(before, after) = render("again", v);
+            check(after.evictions > 0, "a small budget evicts");
+            check(after.misses > before.misses, "evicted tiles miss");
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}